@@ -0,0 +1,82 @@
+#ifndef ASYNC_FILE_READER_HPP
+#define ASYNC_FILE_READER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include "ThreadPool.hpp"
+
+enum class ReadBackend { IoUring, Pread };
+
+// Sequential file reader that keeps several large reads in flight, so the device
+// works on the next blocks while the caller parses the current one. Uses io_uring
+// (raw syscalls, no liburing) when the kernel allows it; otherwise each block is a
+// pread() task on the thread pool. Blocks are handed to the callback in file order
+// on the calling thread. One reader serves one thread at a time; stats accumulate
+// across files.
+class AsyncFileReader {
+public:
+    static const size_t DEFAULT_BLOCK_BYTES = size_t(1) << 20;
+    static const size_t DEFAULT_QUEUE_DEPTH = 8;
+
+    struct Stats {
+        size_t files = 0;
+        size_t reads = 0;
+        size_t bytes = 0;
+        double seconds = 0.0;       // Wall time inside readFile, parsing included
+        size_t maxQueueDepth = 0;   // Most reads in flight at once
+        double meanQueueDepth = 0.0;  // Reads in flight, sampled at every submission
+        double bandwidthMBps() const { return seconds > 0 ? bytes / seconds / (1 << 20) : 0.0; }
+    };
+
+    using BlockFn = std::function<void(const char* data, size_t length)>;
+
+    // IoUring falls back to Pread when io_uring is unavailable (old kernel, seccomp)
+    explicit AsyncFileReader(size_t blockBytes = DEFAULT_BLOCK_BYTES, size_t queueDepth = DEFAULT_QUEUE_DEPTH,
+                             ReadBackend backend = ReadBackend::IoUring);
+    ~AsyncFileReader();
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    // Call fn for every block of the file, in order. Prints the error and returns
+    // false if the file cannot be opened or a read fails. The pread backend runs pool
+    // tasks while it waits, so do not call this holding a lock pool tasks may need.
+    bool readFile(const std::string& path, const BlockFn& fn);
+
+    ReadBackend backend() const { return ring_ ? ReadBackend::IoUring : ReadBackend::Pread; }
+    const char* backendName() const { return ring_ ? "io_uring" : "pread"; }
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = Stats(); }
+
+private:
+    struct Ring;  // io_uring mappings, defined where the kernel header is available
+
+    // One buffer of the read-ahead window
+    struct Slot {
+        std::unique_ptr<char[]> buffer;
+        size_t wanted = 0;
+        size_t offset = 0;
+        long result = 0;  // Bytes read, or -errno
+        std::atomic<bool> done{false};
+    };
+
+    size_t blockBytes_;
+    size_t queueDepth_;
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<Ring> ring_;           // Null: pread backend
+    std::shared_ptr<ThreadPool> pool_;     // pread backend only
+    size_t issued_;                        // Reads submitted; minus completed_ is the queue depth
+    std::atomic<size_t> completed_;
+    size_t depthSamples_;
+    double depthSum_;
+    Stats stats_;
+
+    void submit(int fd, size_t slot);      // Queue a read into slots_[slot]
+    void flush(size_t count);              // Start the queued reads
+    void waitFor(Slot& slot);
+    void reap(bool wait);                  // io_uring: collect completions
+};
+
+#endif // ASYNC_FILE_READER_HPP
@@ -0,0 +1,41 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include "HybridHashTable.hpp"
+#include "TraceRecorder.hpp"
+
+// Throughput and latency of one benchmark run
+struct BenchmarkResult {
+    size_t operations = 0;
+    size_t inserts = 0;
+    size_t searches = 0;
+    size_t removes = 0;
+    size_t updates = 0;
+    size_t hits = 0;  // Inserts that added a key, searches that found one, removes and updates that took effect
+    double seconds = 0.0;
+    double opsPerSec = 0.0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double p999Us = 0.0;
+    double maxUs = 0.0;
+    size_t peakStashSize = 0;   // Largest stash seen during the run (sampled)
+    double collisionRate = 0.0; // Table collisions per insertion at the end of the run
+};
+
+const char* hashModeName(HashMode mode);
+bool parseHashMode(const std::string& name, HashMode& mode);
+
+// Re-execute a trace against the table. paced=true sleeps to reproduce the recorded
+// inter-arrival times; otherwise operations run back to back. Keys missing from the
+// trace are synthesized from their hashes so repeated hashes still map to one key.
+BenchmarkResult replayTrace(HybridHashTable<std::string, std::string>& table, const std::vector<TraceRecord>& trace, bool paced = false);
+
+// The demo workload as a trace: insert every key in order, then search and remove each distinct key
+std::vector<TraceRecord> syntheticTrace(const std::vector<std::string>& keys);
+
+void printBenchmarkResult(const std::string& label, const BenchmarkResult& result, std::ostream& out);
+
+#endif // BENCHMARK_HPP
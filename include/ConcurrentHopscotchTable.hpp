@@ -0,0 +1,102 @@
+#ifndef CONCURRENT_HOPSCOTCH_TABLE_HPP
+#define CONCURRENT_HOPSCOTCH_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "HashFunctions.hpp"
+
+// Concurrent hopscotch hash table (Herlihy, Shavit & Tzafrir).
+//
+// Writers lock the stripes covering the buckets they may touch: a bucket and
+// the ADD_RANGE buckets after it for insert, its neighborhood for remove.
+// search() takes no lock. Entries are immutable nodes published through
+// atomic pointers; when an insert moves an entry closer to make room, it bumps
+// the home bucket's timestamp, and a reader that saw the timestamp change
+// retries. Removed nodes and replaced bucket arrays are freed through epoch
+// reclamation once no reader can still see them.
+//
+// The table never wraps around: it has capacity + ADD_RANGE buckets, and an
+// insert that finds no room within ADD_RANGE doubles the capacity. Doubling does
+// not separate keys whose hashes collide in full: an insert whose neighborhood is
+// full of its own hash, or that MAX_GROWTH_ATTEMPTS doublings did not make room
+// for, fails instead (counted in stats().failedInserts).
+template <typename Key, typename Value>
+class ConcurrentHopscotchTable {
+public:
+    explicit ConcurrentHopscotchTable(size_t initialCapacity = 1024);
+    ~ConcurrentHopscotchTable();
+    ConcurrentHopscotchTable(const ConcurrentHopscotchTable&) = delete;
+    ConcurrentHopscotchTable& operator=(const ConcurrentHopscotchTable&) = delete;
+
+    // Core operations (thread-safe; search is lock-free). insert() returns false if
+    // the key is present or no room could be made for it.
+    bool insert(const Key& key, const Value& value);
+    bool remove(const Key& key);
+    std::optional<Value> search(const Key& key) const;
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    size_t capacity() const;
+    double loadFactor() const;
+
+    struct Stats {
+        size_t size;
+        size_t capacity;
+        size_t searchRetries;   // Reads that saw a concurrent displacement and probed again
+        size_t lockedSearches;  // Reads that gave up retrying and took the home stripe lock
+        size_t displacements;
+        size_t resizes;
+        size_t failedInserts;   // No room for the key, and growing would not make any
+    };
+    Stats stats() const;
+
+private:
+    static const size_t HOP_RANGE = 32;         // Neighborhood size (bits in hopInfo)
+    static const size_t ADD_RANGE = 256;        // How far an insert looks for a free bucket
+    static const size_t LOCK_STRIPE = 64;       // Buckets per lock
+    static const size_t MAX_READ_RETRIES = 8;
+    static const size_t MAX_GROWTH_ATTEMPTS = 4;  // Doublings per insert, and per resize, before giving up
+
+    struct Node {
+        size_t hash;
+        Key key;
+        Value value;
+    };
+
+    struct Bucket {
+        std::atomic<uint32_t> hopInfo{0};    // Bit i: bucket + i holds an entry whose home is this bucket
+        std::atomic<uint32_t> timestamp{0};  // Bumped when one of this bucket's entries moves
+        std::atomic<Node*> node{nullptr};
+    };
+
+    struct BucketArray {
+        explicit BucketArray(size_t capacity);
+        size_t capacity;
+        std::unique_ptr<Bucket[]> buckets;     // capacity + ADD_RANGE
+        size_t lockCount;
+        std::unique_ptr<std::mutex[]> locks;   // One per LOCK_STRIPE buckets
+    };
+
+    std::atomic<BucketArray*> array_;
+    std::atomic<size_t> size_;
+    mutable std::atomic<size_t> searchRetries_;
+    mutable std::atomic<size_t> lockedSearches_;
+    std::atomic<size_t> displacements_;
+    std::atomic<size_t> resizes_;
+    std::atomic<size_t> failedInserts_;
+
+    // Helpers
+    static void lockRange(BucketArray* array, size_t first, size_t last);    // Stripes covering [first, last]
+    static void unlockRange(BucketArray* array, size_t first, size_t last);
+    static Node* findNode(const BucketArray* array, size_t home, size_t hash, const Key& key, size_t* bucket = nullptr);
+    size_t findCloserFreeBucket(BucketArray* array, size_t freeBucket);
+    size_t makeRoom(BucketArray* array, size_t home);
+    static bool sameHashNeighborhood(const BucketArray* array, size_t home, size_t hash);
+    bool place(BucketArray* array, Node* node);  // Insert without locks; caller owns every stripe
+    bool resize(BucketArray* expected, size_t hash);  // False if MAX_GROWTH_ATTEMPTS doublings found no room for hash
+};
+
+#endif // CONCURRENT_HOPSCOTCH_TABLE_HPP
@@ -0,0 +1,108 @@
+#ifndef CONCURRENT_ROBIN_HOOD_TABLE_HPP
+#define CONCURRENT_ROBIN_HOOD_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "HashFunctions.hpp"
+
+// Concurrent Robin Hood hash table with striped locks and optimistic reads.
+//
+// Each stripe of 64 slots has a mutex and a version counter (a seqlock). Writers
+// lock stripes in ascending order, starting at the key's home slot and extending
+// over the probe range they will touch (insert swaps run up to the first empty
+// slot, delete backward shifts run to the end of the cluster), and make the
+// versions odd while they move entries. search() takes no lock: it records the
+// versions of the stripes it reads and retries if any changed. Entries are
+// immutable nodes freed through epoch reclamation.
+//
+// The table does not wrap around; a probe that would run past MAX_PROBE slots, or
+// a load above MAX_LOAD_FACTOR, doubles the capacity. Doubling does not separate
+// keys whose hashes collide in full: an insert whose probe run is all its own
+// hash, or that MAX_GROWTH_ATTEMPTS doublings did not make room for, fails instead
+// (counted in stats().failedInserts).
+template <typename Key, typename Value>
+class ConcurrentRobinHoodTable {
+public:
+    explicit ConcurrentRobinHoodTable(size_t initialCapacity = 1024);
+    ~ConcurrentRobinHoodTable();
+    ConcurrentRobinHoodTable(const ConcurrentRobinHoodTable&) = delete;
+    ConcurrentRobinHoodTable& operator=(const ConcurrentRobinHoodTable&) = delete;
+
+    // Core operations (thread-safe; search is lock-free unless writers keep racing it).
+    // insert() returns false if the key is present or no room could be made for it.
+    bool insert(const Key& key, const Value& value);
+    bool remove(const Key& key);
+    std::optional<Value> search(const Key& key) const;
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    size_t capacity() const;
+    double loadFactor() const;
+
+    struct Stats {
+        size_t size;
+        size_t capacity;
+        size_t searchRetries;   // Optimistic reads invalidated by a concurrent writer
+        size_t lockedSearches;  // Reads that gave up retrying and locked their probe range
+        size_t resizes;
+        size_t failedInserts;   // No room for the key, and growing would not make any
+    };
+    Stats stats() const;
+
+private:
+    static const size_t LOCK_STRIPE = 64;  // Slots per lock
+    static const size_t MAX_PROBE = 256;   // Longest probe before the table grows; also the tail padding
+    static constexpr double MAX_LOAD_FACTOR = 0.9;
+    static const size_t MAX_READ_RETRIES = 8;
+    static const size_t MAX_GROWTH_ATTEMPTS = 4;  // Doublings per insert, and per resize, before giving up
+
+    struct Node {
+        size_t hash;
+        Key key;
+        Value value;
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex lock;
+        std::atomic<uint64_t> version{0};  // Odd while a writer is moving entries
+    };
+
+    struct SlotArray {
+        explicit SlotArray(size_t capacity);
+        size_t capacity;
+        std::unique_ptr<std::atomic<Node*>[]> slots;  // capacity + MAX_PROBE
+        size_t stripeCount;
+        std::unique_ptr<Stripe[]> stripes;
+        size_t home(size_t hash) const { return hash % capacity; }
+        size_t slotCount() const { return capacity + MAX_PROBE; }
+    };
+
+    // Stripes [first, last] held by one writer
+    struct LockedRange {
+        SlotArray* array;
+        size_t first;
+        size_t last;
+        LockedRange(SlotArray* array, size_t slot);
+        ~LockedRange();
+        void extendTo(size_t slot);  // Lock up to slot's stripe, in order
+        void beginWrite();           // Make every held stripe's version odd
+        void endWrite();
+    };
+
+    std::atomic<SlotArray*> array_;
+    std::atomic<size_t> size_;
+    mutable std::atomic<size_t> searchRetries_;
+    mutable std::atomic<size_t> lockedSearches_;
+    std::atomic<size_t> resizes_;
+    std::atomic<size_t> failedInserts_;
+
+    // Helpers
+    static std::optional<Value> probe(const SlotArray* array, size_t hash, const Key& key, bool& consistent);
+    static bool place(SlotArray* array, Node* node);  // Insert without locks; caller owns every stripe
+    bool resize(SlotArray* expected, size_t hash);  // False if MAX_GROWTH_ATTEMPTS doublings found no room for hash
+};
+
+#endif // CONCURRENT_ROBIN_HOOD_TABLE_HPP
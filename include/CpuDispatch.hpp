@@ -0,0 +1,39 @@
+#ifndef CPU_DISPATCH_HPP
+#define CPU_DISPATCH_HPP
+
+#include <string>
+#include <cstddef>
+
+// Runtime CPU feature dispatch. Every SIMD kernel is compiled in several
+// variants (GCC/Clang target attributes), and the best one the running CPU
+// supports is bound once at startup. HYBRID_HASH_ISA=generic|sse4.2|avx2|avx512
+// caps the tier for A/B testing.
+namespace CpuDispatch {
+    enum class IsaLevel { Generic = 0, SSE42 = 1, AVX2 = 2, AVX512 = 3 };
+
+    struct CpuFeatures {
+        bool sse42 = false;
+        bool popcnt = false;
+        bool avx2 = false;
+        bool bmi1 = false;
+        bool bmi2 = false;
+        bool avx512bw = false;
+    };
+
+    struct Kernels {
+        // Offset of the first byte equal to c, or length if there is none (CSV parsing)
+        size_t (*findByte)(const char* data, size_t length, char c);
+        const char* findByteVariant;
+    };
+
+    const CpuFeatures& features();
+    IsaLevel selectedLevel();  // Highest tier allowed by the CPU and the override
+    const Kernels& kernels();  // Bound on first use
+    std::string report();      // Detected features and the variant chosen per kernel
+
+    inline size_t findByte(const char* data, size_t length, char c) {
+        return kernels().findByte(data, length, c);
+    }
+}
+
+#endif // CPU_DISPATCH_HPP
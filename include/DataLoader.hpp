@@ -0,0 +1,53 @@
+#ifndef DATA_LOADER_HPP
+#define DATA_LOADER_HPP
+
+#include <string>
+#include <vector>
+#include "HybridHashTable.hpp"
+
+// Load "key,value" lines from a CSV file; keys of inserted rows are appended to keys.
+// An empty table is first presized from a distinct-key estimate of the file.
+void loadFromFile(HybridHashTable<std::string, std::string>& table, const std::string& filename, std::vector<std::string>& keys,
+                  bool presize = true);
+
+// Which row wins when a key appears more than once, counting rows in file list
+// order and line order within a file
+enum class DuplicatePolicy { FirstWins, LastWins };
+
+struct LoadReport {
+    size_t files = 0;
+    size_t failedFiles = 0;  // Could not be opened or read
+    size_t bytes = 0;
+    size_t rows = 0;         // Well-formed "key,value" lines
+    size_t inserted = 0;     // New keys
+    size_t replaced = 0;     // LastWins: existing values overwritten
+    size_t ignored = 0;      // FirstWins: duplicate rows dropped
+    double seconds = 0.0;
+    double rowsPerSecond() const { return seconds > 0 ? rows / seconds : 0.0; }
+    double bandwidthMBps() const { return seconds > 0 ? bytes / seconds / (1 << 20) : 0.0; }
+};
+
+// Load several CSV files; an empty table is first presized as above, from one
+// estimate over all the files. Files are read and parsed concurrently on parser
+// threads started for the load, but rows are applied to the table in list order,
+// so the result does not depend on timing. Parsed rows waiting for their turn are
+// capped at maxBufferedBytes; the file being applied is never held back.
+LoadReport loadFromFiles(HybridHashTable<std::string, std::string>& table, const std::vector<std::string>& files,
+                         std::vector<std::string>& keys, DuplicatePolicy policy = DuplicatePolicy::FirstWins,
+                         size_t maxBufferedBytes = size_t(64) << 20, bool presize = true);
+
+// Expand a glob pattern ("logs/*.csv") or a directory (its regular files) into a
+// sorted file list. Prints the error and returns false when nothing matches.
+bool expandFilePattern(const std::string& pattern, std::vector<std::string>& files);
+
+// Estimate the file's distinct keys with HyperLogLog and grow the table so they fit
+// below its target load (min of maxLoadFactor and 0.75). Never shrinks; returns the
+// estimate, or 0 if the file cannot be read. presizeForFiles counts the keys of all
+// the files together.
+size_t presizeForFile(HybridHashTable<std::string, std::string>& table, const std::string& filename);
+size_t presizeForFiles(HybridHashTable<std::string, std::string>& table, const std::vector<std::string>& files);
+
+// Read only the key column of a CSV file (lines without a comma are taken whole)
+bool readKeysFromFile(const std::string& filename, std::vector<std::string>& keys);
+
+#endif // DATA_LOADER_HPP
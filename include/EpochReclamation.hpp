@@ -0,0 +1,35 @@
+#ifndef EPOCH_RECLAMATION_HPP
+#define EPOCH_RECLAMATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Epoch-based memory reclamation for lock-free readers (one process-wide domain).
+// Readers hold an Epoch::Guard while they dereference shared pointers; writers
+// unlink an object first and then retire() it. A retired object is deleted once
+// every thread that might still see it has left its guard.
+namespace Epoch {
+    class Guard {
+    public:
+        Guard();
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    // Defer deleter(object) until no guard that could have seen object is active
+    void retire(void* object, void (*deleter)(void*));
+
+    template <typename T>
+    void retire(T* object) {
+        retire(static_cast<void*>(object), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    // Try to advance the epoch and free what is safe; retire() does this periodically
+    void reclaim();
+
+    // Objects retired but not yet freed, across all threads
+    size_t pending();
+}
+
+#endif // EPOCH_RECLAMATION_HPP
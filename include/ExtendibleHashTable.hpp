@@ -0,0 +1,74 @@
+#ifndef EXTENDIBLE_HASH_TABLE_HPP
+#define EXTENDIBLE_HASH_TABLE_HPP
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "HybridHashTable.hpp"
+
+// Extendible hashing over fixed-size HybridHashTable segments.
+//
+// A directory of 2^globalDepth entries, indexed by the top bits of the key's
+// hash, points at segments; a segment with local depth d is shared by the
+// 2^(globalDepth - d) entries that agree on its top d bits. When a segment passes
+// the split load it alone is split in two, so growth moves one segment's keys at
+// a time instead of rehashing the whole table. Each segment runs in the configured
+// mode with its own lock; the directory lock is only taken exclusively to split.
+template <typename Key, typename Value>
+class ExtendibleHashTable {
+public:
+    // config.maxLoadFactor is the segment split threshold; the other fields are
+    // passed to every segment table
+    ExtendibleHashTable(size_t segmentCapacity = 4096, HashMode mode = HashMode::Hopscotch,
+                        const HashTableConfig& config = HashTableConfig());
+
+    // Core operations (thread-safe)
+    bool insert(const Key& key, const Value& value);
+    bool remove(const Key& key);
+    std::optional<Value> search(const Key& key) const;
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    size_t capacity() const;  // Slots across all segments
+    double loadFactor() const;
+
+    struct Stats {
+        size_t size;
+        size_t capacity;
+        size_t segments;
+        size_t globalDepth;
+        size_t directorySize;
+        size_t splits;
+        size_t maxSegmentSize;
+    };
+    Stats stats() const;
+
+private:
+    using Table = HybridHashTable<Key, Value>;
+    struct Segment {
+        std::unique_ptr<Table> table;
+        size_t localDepth;
+    };
+
+    mutable TableMutex mutex_;  // Shared for operations, exclusive for splits
+    std::vector<std::shared_ptr<Segment>> directory_;
+    size_t globalDepth_;
+    size_t segmentCapacity_;
+    HashMode mode_;
+    HashTableConfig segmentConfig_;
+    double splitLoadFactor_;
+    std::atomic<size_t> size_;
+    size_t splits_;
+    // Splits stop this many bits past what the entry count needs: keys sharing a full
+    // hash never separate, and their segment's stash takes them instead
+    static const size_t SPLIT_DEPTH_SLACK = 8;
+
+    static uint64_t directoryHash(const Key& key);  // Independent of the segments' own slot hash
+    size_t directoryIndex(uint64_t hash) const { return globalDepth_ == 0 ? 0 : hash >> (64 - globalDepth_); }
+    std::unique_ptr<Table> makeTable() const;
+    size_t maxDepth() const;
+    bool overloaded(const Segment& segment) const;
+    void split(uint64_t hash);  // Caller holds the exclusive lock
+};
+
+#endif // EXTENDIBLE_HASH_TABLE_HPP
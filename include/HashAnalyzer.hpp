@@ -0,0 +1,45 @@
+#ifndef HASH_ANALYZER_HPP
+#define HASH_ANALYZER_HPP
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstddef>
+#include "HybridHashTable.hpp"
+
+// Distribution quality report for a key set hashed with the table's HashUtils functions
+struct HashAnalysis {
+    size_t numKeys = 0;
+    size_t capacity = 0;
+    size_t hopRange = 0;
+
+    // occupancyHistogram[c] = buckets that receive exactly c keys (last bin collects the rest)
+    std::vector<size_t> occupancyHistogram;
+    double chiSquared = 0.0;       // Against a uniform spread, capacity - 1 degrees of freedom
+    double chiSquaredZ = 0.0;      // Standard deviations from the uniform expectation (|z| < 3 is healthy)
+    size_t longestCluster = 0;     // Longest run of occupied slots under linear probing
+
+    // Predicted probe lengths per mode (successful lookups)
+    double robinHoodMeanProbes = 0.0;    // 1 + mean displacement from the home bucket
+    size_t robinHoodMaxDisplacement = 0; // Linear-probing bound; Robin Hood evens this out
+    double hopscotchMeanProbes = 0.0;    // Keys sharing the home bitmap that a lookup scans
+    double hopscotchOverflowRate = 0.0;  // Keys that do not fit their neighborhood block
+    double cuckooMeanProbes = 0.0;       // 1 + share of keys pushed out of their hash1 bucket
+
+    // Cuckoo hash independence
+    double cuckooCorrelation = 0.0;      // Pearson correlation of hash1 and hash2 bucket indices
+    double cuckooSameBucketRate = 0.0;   // Keys whose hash1 and hash2 buckets coincide
+};
+
+// Analyze a key set as if inserted into a table of the given capacity
+template <typename Key>
+HashAnalysis analyzeKeys(const std::vector<Key>& keys, size_t capacity, size_t hopRange = 32);
+
+// Analyze the live keys of a table at its current capacity and hop range
+// (reads a snapshot, so writers are not blocked)
+template <typename Key, typename Value>
+HashAnalysis analyzeTable(const HybridHashTable<Key, Value>& table);
+
+void printHashAnalysis(const HashAnalysis& analysis, std::ostream& out);
+
+#endif // HASH_ANALYZER_HPP
@@ -3,6 +3,9 @@
 
 #include <functional>
 #include <string>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
 
 namespace HashUtils {
     // Primary hash for Cuckoo
@@ -23,6 +26,36 @@ namespace HashUtils {
     size_t hash(const Key& key) {
         return std::hash<Key>{}(key);
     }
+
+    // 64-bit finalizer (splitmix64) for seeded variants after a reseed
+    constexpr size_t mix(uint64_t h) {
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return static_cast<size_t>(h);
+    }
+
+    // FNV-1a, usable in constant expressions
+    constexpr uint64_t fnv1a(std::string_view s) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (char c : s) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    // Compile-time hashes for StaticHashTable keys
+    constexpr size_t staticHash(std::string_view key, uint64_t seed) {
+        return mix(fnv1a(key) ^ seed);
+    }
+
+    template <typename Key, typename = std::enable_if_t<std::is_integral_v<Key> || std::is_enum_v<Key>>>
+    constexpr size_t staticHash(Key key, uint64_t seed) {
+        return mix(static_cast<uint64_t>(key) ^ seed);
+    }
 }
 
 #endif // HASH_FUNCTIONS_HPP
\ No newline at end of file
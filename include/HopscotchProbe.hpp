@@ -0,0 +1,21 @@
+#ifndef HOPSCOTCH_PROBE_HPP
+#define HOPSCOTCH_PROBE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Returned by hopscotchProbe when no slot matches
+constexpr size_t HOPSCOTCH_NOT_FOUND = static_cast<size_t>(-1);
+
+// Hopscotch lookup kernel shared by HybridHashTable and StaticHashTable.
+// Bit i of hopBitmap marks slot start + i as holding a key whose home bucket
+// owns the bitmap; match(slot) is tried on those slots in order.
+template <typename Match>
+constexpr size_t hopscotchProbe(uint32_t hopBitmap, size_t start, size_t end, size_t hopRange, Match&& match) {
+    for (size_t i = 0; i < hopRange && (start + i) < end; ++i) {
+        if ((hopBitmap & (1U << i)) && match(start + i)) return start + i;
+    }
+    return HOPSCOTCH_NOT_FOUND;
+}
+
+#endif // HOPSCOTCH_PROBE_HPP
@@ -0,0 +1,39 @@
+#ifndef HOT_KEY_TRACKER_HPP
+#define HOT_KEY_TRACKER_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+
+// Sampled heavy-hitters tracker using the space-saving algorithm.
+// Only 1 in sampleRate calls to record() touch the shared counters, so the
+// hot path is a thread-local increment.
+template <typename Key>
+class HotKeyTracker {
+public:
+    struct HotKey {
+        Key key;
+        size_t count;  // Estimated operations (sampled count scaled by sample rate)
+        size_t error;  // Upper bound on overestimation, same scale as count
+    };
+
+    HotKeyTracker(size_t trackedKeys = 64, size_t sampleRate = 64);
+
+    void record(const Key& key);             // Thread-safe
+    std::vector<HotKey> topK(size_t k) const; // Highest estimated counts first
+    size_t samples() const;
+    size_t sampleRate() const { return sampleRate_; }
+    void reset();
+
+private:
+    size_t trackedKeys_;
+    size_t sampleRate_;
+    mutable std::mutex mutex_;
+    std::vector<HotKey> counters_;              // Space-saving counters (unscaled)
+    std::unordered_map<Key, size_t> index_;     // Key -> position in counters_
+    std::atomic<size_t> samples_;  // Readable without the lock
+};
+
+#endif // HOT_KEY_TRACKER_HPP
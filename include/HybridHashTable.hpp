@@ -9,7 +9,18 @@
 #include <cstdint>  // For uint32_t
 #include <mutex>    // For multithreading
 #include <shared_mutex>  // For read-write locks
+#include <memory>   // For snapshot handles
+#include <type_traits>
+#include <atomic>
+#include <chrono>
 #include "HashFunctions.hpp"
+#include "SegmentedArray.hpp"
+#include "HopscotchProbe.hpp"
+#include "HotKeyTracker.hpp"
+#include "LockProfiler.hpp"
+#include "TraceRecorder.hpp"
+#include "MemoryGovernor.hpp"
+#include "SlowOpRecorder.hpp"
 
 // Enum for hashing modes
 enum class HashMode { Cuckoo, Hopscotch, RobinHood };
@@ -17,91 +28,518 @@ enum class HashMode { Cuckoo, Hopscotch, RobinHood };
 // Tombstone for deletions
 const std::string TOMBSTONE = "__TOMBSTONE__";
 
+// Tunable parameters; defaults are the original hard-coded values.
+// tools/autotune searches these for a recorded workload.
+struct HashTableConfig {
+    size_t hopRange = 32;            // Hopscotch neighborhood, at most 32 (hopInfo_ bitmap width)
+    size_t maxDisplacements = 500;   // Hopscotch displacement search distance
+    int maxEvictions = 500;          // Cuckoo eviction chain length before stashing
+    size_t maxProbeDistance = 500;   // Robin Hood probe limit before stashing
+    double highLoadThreshold = 0.8;  // Hybrid switching (disabled, unused): prefer Robin Hood above this load
+    double highCollisionRate = 0.5;  // Hybrid switching (disabled, unused): prefer Cuckoo above this collision rate
+    double maxLoadFactor = 0.75;     // Inserts past this load double the capacity
+    size_t stashEventThreshold = 64; // Stash size that fires StashAboveThreshold/StashBelowThreshold
+};
+
+// Latency-relevant table events delivered to observers
+// RehashFailed: the new layout could not hold every entry (stash full), so the old one was kept
+enum class TableEventType { ResizeBegin, ResizeEnd, ModeSwitch, StashAboveThreshold, StashBelowThreshold, Reseed, GrowthRefused,
+                            RehashFailed };
+
+struct TableEvent {
+    TableEventType type;
+    size_t oldCapacity;
+    size_t newCapacity;
+    HashMode oldMode;
+    HashMode newMode;
+    size_t size;        // Elements when the event fired
+    size_t stashSize;
+    double durationMs;  // Time spent in the operation (ResizeEnd, ModeSwitch, Reseed); 0 otherwise
+};
+
+// Observers run on the thread that caused the event, after the table lock is released,
+// so they may call back into the table
+using TableObserver = std::function<void(const TableEvent&)>;
+
+// How clone() copies: Shared is O(1) and both tables copy segments on their first
+// write; Deep copies every segment up front, in parallel
+enum class CloneMode { Shared, Deep };
+
+// What a table does when its memory governor refuses a growth step:
+// Refuse keeps the capacity (the load and stash grow), SwitchMode rebuilds in place
+// as Robin Hood over the slots already in use, which holds higher loads (the rebuild
+// itself needs room for a copy of the entries, so it is skipped if the governor
+// refuses that too), and Evict drops a resident entry for every new key until
+// growth fits again (for tables used as caches)
+enum class MemoryPolicy { Refuse, SwitchMode, Evict };
+
+// Values the atomic-update API supports: lock-free sizes, copyable with memcpy
+template <typename T>
+inline constexpr bool isAtomicValue = std::is_trivially_copyable_v<T> &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
 template <typename Key, typename Value>
 class HybridHashTable {
 public:
     // Constructor
     HybridHashTable(size_t initialSize = 16, double maxLoadFactor = 0.75);
+    HybridHashTable(size_t initialSize, const HashTableConfig& config);
 
     // Destructor
     ~HybridHashTable();
 
     // Core operations (thread-safe)
     bool insert(const Key& key, const Value& value);
+    bool insertOrAssign(const Key& key, const Value& value);  // True if inserted, false if an existing value was replaced
     bool remove(const Key& key);
     std::optional<Value> search(const Key& key) const;
 
+    // Look up every key in [begin, end) and call callback(key, std::optional<Value>)
+    // in order. Keys are hashed and their slots prefetched a few lookups ahead of
+    // the probe, so a sequential stream overlaps its cache misses.
+    template <typename InputIt, typename Callback>
+    void lookupStream(InputIt begin, InputIt end, Callback&& callback) const;
+
+    // Atomic updates of existing keys for small trivially copyable values (counters,
+    // flags). They take only the shared lock unless the entry's segment is still
+    // shared with a snapshot or the key is pinned in the front table. All return
+    // false/nullopt when the key is absent; compareExchange then leaves expected alone,
+    // and a compareExchange that fails keeps the entry's version.
+    template <typename V = Value, typename = std::enable_if_t<isAtomicValue<V> && std::is_integral_v<V>>>
+    std::optional<Value> fetchAdd(const Key& key, Value delta);  // Returns the previous value
+    template <typename V = Value, typename = std::enable_if_t<isAtomicValue<V>>>
+    std::optional<Value> exchange(const Key& key, Value desired);
+    template <typename V = Value, typename = std::enable_if_t<isAtomicValue<V>>>
+    bool compareExchange(const Key& key, Value& expected, Value desired);
+    template <typename V = Value, typename = std::enable_if_t<isAtomicValue<V>>>
+    std::optional<Value> load(const Key& key) const;
+
+    // Optimistic read-modify-write: each write to a key gets a fresh version from a
+    // table-wide clock (resizes keep it), so a version never repeats even across
+    // remove and re-insert. Both updates are a single probe under one exclusive lock.
+    struct Versioned {
+        Value value;
+        uint64_t version;
+    };
+    std::optional<Versioned> searchVersioned(const Key& key) const;
+    bool updateIfVersion(const Key& key, const Value& desired, uint64_t expectedVersion);  // False if absent or changed
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired);       // False if absent or different
+
     // Utility methods
     size_t size() const;
     double loadFactor() const;
-    void resize(size_t newSize);
+    bool resize(size_t newSize);  // False if the memory governor refused it or the entries did not fit
     void setMode(HashMode mode);
+    void clear();  // Remove everything, keep capacity, mode and config
+    void reseed(uint64_t seed);  // Switch to seeded hash functions and rehash in place (kept unless that fails)
+    size_t capacity() const;
+    HashMode mode() const;
+    HashTableConfig config() const;
+
+    // Consistent read-only views. Taking a snapshot is O(1): it shares the
+    // table's segments, and later writes copy only the segments they touch.
+    using Snapshot = std::shared_ptr<const HybridHashTable<Key, Value>>;
+    Snapshot snapshot() const;
+
+    // Independent, writable copy with the same contents, mode, config, hash seed and
+    // version clock. Observers, hot-key tracking, traces and the memory governor are
+    // not carried over, nor is the slow-operation recorder. Deep copies run on pool (nullptr: ThreadPool::defaultPool()).
+    std::unique_ptr<HybridHashTable> clone(CloneMode mode = CloneMode::Shared, ThreadPool* pool = nullptr) const;
+
+    // Visit every live entry under a shared lock
+    template <typename Fn>
+    void forEach(Fn&& fn) const;
+
+    // Runtime statistics
+    struct Stats {
+        size_t size;
+        size_t capacity;
+        double loadFactor;
+        HashMode mode;
+        size_t stashSize;
+        size_t totalInsertions;
+        size_t totalCollisions;
+        size_t totalProbes;
+        std::vector<typename HotKeyTracker<Key>::HotKey> hotKeys;  // Empty unless tracking is enabled
+        std::vector<Key> pinnedKeys;  // Keys currently served from the front table
+        LockStats lock;  // Table lock contention; zeros unless built with HYBRID_HASH_LOCK_PROFILING
+        size_t memoryBytes;     // Estimated slot arrays and stash (keys' and values' own heap excluded)
+        size_t memoryHeadroom;  // From the memory governor; SIZE_MAX without one or without a limit
+        size_t refusedGrowths;
+        size_t failedRehashes;  // Rebuilds rolled back because the entries did not fit
+        size_t evictions;
+    };
+    Stats stats() const;
+
+    // Sampled hot-key tracking. With pinnedKeys > 0 the hottest keys are also
+    // copied into a small front table that lookups check before the main probe.
+    void enableHotKeyTracking(size_t sampleRate = 64, size_t trackedKeys = 64, size_t pinnedKeys = 0);
+    void disableHotKeyTracking();
+    void refreshHotKeys();  // Rebuild the front table from the current top-k now
+
+    // Log insert/search/remove calls to a workload trace (nullptr stops recording)
+    void setTraceRecorder(std::shared_ptr<TraceRecorder> recorder);
+
+    // Keep insert/search/remove/resize and compareAndSet/updateIfVersion calls slower
+    // than the recorder's threshold, with the mode, probe and displacement counts and
+    // stash size they saw (nullptr detaches). While attached each call costs two clock
+    // reads; only slow calls hash their key. Not timed: lookupStream, searchVersioned
+    // and the atomic operations (fetchAdd, exchange, compareExchange, load), which
+    // are meant to stay lock-light.
+    void setSlowOpRecorder(std::shared_ptr<SlowOpRecorder> recorder);
+
+    // Check growth against a memory budget first (nullptr removes the governor).
+    // A refused automatic growth fires GrowthRefused, applies the policy and is
+    // retried at most every GROWTH_RETRY_MS.
+    void setMemoryGovernor(std::shared_ptr<const MemoryGovernor> governor, MemoryPolicy policy = MemoryPolicy::Refuse);
+
+    // Event hooks for resize, mode switch, stash threshold crossings, reseed, refused growth and failed rehashes
+    size_t addObserver(TableObserver observer);  // Returns an id for removeObserver
+    void removeObserver(size_t id);
 
 private:
+    // Snapshot copy; caller must hold other.mutex_ exclusively
+    HybridHashTable(const HybridHashTable& other);
+    HybridHashTable& operator=(const HybridHashTable&) = delete;
+
+    // Key/value plus the clock value of its last write (see searchVersioned)
+    struct Entry : std::pair<Key, Value> {
+        uint64_t version = 0;
+        Entry() = default;
+        Entry(const Key& key, const Value& value, uint64_t version = 0)
+            : std::pair<Key, Value>(key, value), version(version) {}
+    };
+    using Slot = std::optional<Entry>;
+    using Stash = std::vector<Entry>;
+
     // Shared structures
-    mutable std::shared_mutex mutex_;  // Read-write lock for thread safety
-    std::vector<std::optional<std::pair<Key, Value>>> table_;  // Main table (used differently per mode)
+    mutable TableMutex mutex_;  // Read-write lock for thread safety (profiled if HYBRID_HASH_LOCK_PROFILING)
+    SegmentedArray<Slot> table_;  // Main table (used differently per mode)
     size_t capacity_;
     size_t numElements_;
-    double maxLoadFactor_;
+    HashTableConfig config_;
     HashMode currentMode_;
 
     // Cuckoo-specific
-    std::vector<std::optional<std::pair<Key, Value>>> table2_;  // Second table for Cuckoo
+    SegmentedArray<Slot> table2_;  // Second table for Cuckoo
     std::function<size_t(const Key&)> hash1_;
     std::function<size_t(const Key&)> hash2_;
-    static const int MAX_EVICTIONS = 500;
 
     // Hopscotch/Robin Hood-specific (single hash)
     std::function<size_t(const Key&)> hash_;
 
     // Hopscotch-specific
-    std::vector<uint32_t> hopInfo_;  // Bitmap for neighborhoods
-    static const size_t HOP_RANGE = 32;
-    static const size_t MAX_DISPLACEMENTS = 500;
+    SegmentedArray<uint32_t> hopInfo_;  // Bitmap for neighborhoods
 
     // Robin Hood-specific
-    std::vector<size_t> probeDistances_;  // Probe distances
-    static const size_t MAX_PROBE_DISTANCE = 500;
+    SegmentedArray<size_t> probeDistances_;  // Probe distances
 
     // Overflow stash
-    std::vector<std::pair<Key, Value>> stash_;
+    std::shared_ptr<Stash> stash_;  // Shared with snapshots until the next stash write
     static const size_t MAX_STASH_SIZE = 10000000;
 
+    // Hot-key tracking (tracker has its own lock; front table changes only under the exclusive lock)
+    struct PinnedEntry {
+        size_t hash;
+        Key key;
+        Value value;
+    };
+    std::unique_ptr<HotKeyTracker<Key>> hotKeys_;
+    mutable std::vector<PinnedEntry> frontTable_;  // Cache: rebuilt by lookups too, under the exclusive lock
+    size_t maxPinnedKeys_;
+    mutable size_t nextPinRefresh_;  // Tracker sample count at which the front table is rebuilt
+    static const size_t PIN_REFRESH_SAMPLES = 1024;
+
+    // Streaming lookups: keys per shared-lock hold, and how far prefetches run ahead of probes
+    static const size_t STREAM_CHUNK = 256;
+    static const size_t PREFETCH_DISTANCE = 8;
+    struct ProbeHint {
+        size_t hash;    // hash_(key), also used by the front table
+        size_t index1;  // Home slot (hash1 slot for Cuckoo)
+        size_t index2;  // Cuckoo only
+    };
+    static const size_t NO_INDEX = static_cast<size_t>(-1);
+
+    // Rehashes of at least this many entries run on the thread pool
+    static const size_t PARALLEL_REHASH_MIN = size_t(1) << 15;
+    static const size_t REHASH_PARTS_PER_THREAD = 4;
+
+    // Workload tracing
+    std::shared_ptr<TraceRecorder> trace_;
+
+    // Slow-operation recording; the flag lets calls skip the clock without the lock
+    std::shared_ptr<SlowOpRecorder> slowOps_;
+    std::atomic<bool> recordSlowOps_;
+
+    // Events are queued under the table lock and delivered after it is released
+    using ObserverList = std::vector<std::pair<size_t, TableObserver>>;
+    std::mutex observersMutex_;
+    std::shared_ptr<const ObserverList> observers_;  // Replaced, never mutated, so dispatch can copy it
+    size_t nextObserverId_;
+    std::vector<TableEvent> pendingEvents_;
+    bool growthClaimed_;  // One inserter owns an automatic resize at a time
+    bool stashAboveThreshold_;
+
+    // Memory governor; growth checks happen under the exclusive lock
+    std::shared_ptr<const MemoryGovernor> governor_;
+    MemoryPolicy memoryPolicy_;
+    bool evicting_;  // Evict policy engaged: inserts past the load limit displace a resident entry
+    std::chrono::steady_clock::time_point growthRetryAt_;
+    size_t refusedGrowths_;
+    size_t failedRehashes_;
+    size_t evictions_;
+    size_t evictCursor_;  // Round-robin victim search position
+    static constexpr int64_t GROWTH_RETRY_MS = 100;
+    static constexpr double SWITCH_MODE_MAX_LOAD = 0.9;  // SwitchMode: Robin Hood load the entries must fit at
+
+    // Entry versions; atomic because in-place atomic updates bump it under the shared lock
+    std::atomic<uint64_t> versionClock_;
+
     // Metrics for hybrid switching
     size_t totalInsertions_;
     size_t totalCollisions_;
     size_t totalProbes_;
-
-    // Hybrid-specific thresholds
-    static constexpr double HIGH_LOAD_THRESHOLD = 0.8;
-    static constexpr double HIGH_COLLISION_RATE = 0.5;
+    size_t totalDisplacements_;  // Cuckoo evictions, Robin Hood swaps, Hopscotch moves
 
     // Helpers
     size_t hash(const Key& key) const { return hash_(key) % capacity_; }  // For non-Cuckoo
     size_t hash1(const Key& key) const { return hash1_(key) % capacity_; }  // Cuckoo
     size_t hash2(const Key& key) const { return hash2_(key) % capacity_; }  // Cuckoo
-    bool isTombstone(const std::optional<std::pair<Key, Value>>& slot) const {
+    bool isTombstone(const Slot& slot) const {
         return slot && slot->first == TOMBSTONE;
     }
-    size_t getNeighborhoodStart(size_t index) const { return (index / HOP_RANGE) * HOP_RANGE; }
-    size_t getNeighborhoodEnd(size_t index) const { return std::min(getNeighborhoodStart(index) + HOP_RANGE, capacity_); }
+    size_t getNeighborhoodStart(size_t index) const { return (index / config_.hopRange) * config_.hopRange; }
+    size_t getNeighborhoodEnd(size_t index) const { return std::min(getNeighborhoodStart(index) + config_.hopRange, capacity_); }
     size_t getProbeDistance(size_t idealIndex, size_t currentIndex) const {
         return (currentIndex >= idealIndex) ? (currentIndex - idealIndex) : (capacity_ - idealIndex + currentIndex);
     }
-    double computeLoadFactor() const { return static_cast<double>(numElements_) / (capacity_ + stash_.size()); }  // No lock version
+    double computeLoadFactor() const { return static_cast<double>(numElements_) / (capacity_ + stash_->size()); }  // No lock version
     void switchModeIfNeeded(double currentLoad);  // Pass load factor to avoid locking
     void updateHopInfo(size_t baseIndex, size_t targetIndex, bool add);
-    size_t findEmptySlot(size_t start, size_t end);
+    size_t findEmptySlot(size_t start, size_t end) const;
     bool displace(size_t index);
     void backwardShift(size_t startIndex);
-    bool insertIntoStash(const Key& key, const Value& value);
-    std::optional<Value> searchStash(const Key& key) const;
+    bool insertIntoStash(const Entry& entry);
     bool removeFromStash(const Key& key);
     void switchModeIfNeeded();
     double collisionRate() const { return totalInsertions_ > 0 ? static_cast<double>(totalCollisions_) / totalInsertions_ : 0.0; }
-    void rehash();
+    bool rehash(size_t newCapacity);  // False if it lost entries and was rolled back
+    bool rehash(size_t newCapacity, HashMode mode);  // Also converts the entries to another mode
+    void rehashInPlace(size_t newCapacity, HashMode mode);  // On the calling thread
+    void parallelRehash(size_t newCapacity, HashMode mode, ThreadPool& pool);
+    void clearSlots();
+    size_t slotBytes(size_t capacity, HashMode mode) const;  // Arrays that mode writes (others stay lazy)
+    size_t rehashBytes(size_t newCapacity, HashMode mode) const;
+    bool governorAllows(size_t newCapacity, HashMode mode) const;
+    void refuseGrowth(size_t newCapacity);
+    void applyMemoryPolicy();  // After a refused automatic growth
+    bool evictOne();
+    bool insertInternal(const Key& key, const Value& value, uint64_t version);
+    bool removeInternal(const Key& key);
+    bool claimGrowth();
+    void grow();
+    TableEvent makeEvent(TableEventType type) const;
+    void checkStashThreshold();
+    void dispatchEvents(const std::vector<TableEvent>& events);
     std::optional<Value> searchInternal(const Key& key) const;  // No lock version for internal use
+    std::optional<Value> searchInternal(const Key& key, const ProbeHint& hint) const;
+    ProbeHint probeHint(const Key& key) const;  // Hashes only, no prefetch
+    enum class EntryLocation { None, Table, Table2, Stash };
+    EntryLocation findEntry(const Key& key, const ProbeHint& hint, size_t& index) const;
+    const PinnedEntry* findPinned(const Key& key, size_t hash) const;
+    bool sharedEntrySlot(const Key& key, Entry*& entry) const;  // False if key is absent; entry null if the exclusive lock is needed
+    Entry* exclusiveEntrySlot(const Key& key);
+    uint64_t nextVersion() { return versionClock_.fetch_add(1, std::memory_order_relaxed) + 1; }
+    void syncPinned(const Key& key, const Value& value);
+    template <typename Op>
+    bool updateValue(const Key& key, Op&& op);
+    void publishVersion(Entry* entry, uint64_t version);
+    // Values that atomic ops may be changing under the shared lock are read atomically
+    decltype(auto) readValue(const Value& value) const {
+        if constexpr (isAtomicValue<Value>) {
+            Value out;
+            __atomic_load(&value, &out, __ATOMIC_ACQUIRE);
+            return out;
+        } else {
+            return (value);
+        }
+    }
+    ProbeHint prefetchProbe(const Key& key) const;  // Hash and prefetch the slots searchInternal will read
+    void lookupChunk(const std::vector<Key>& keys, std::vector<std::optional<Value>>& results) const;
+    Stash& mutableStash();  // Copy-on-write access to the stash
+    void recordAccess(const Key& key) const { if (hotKeys_) hotKeys_->record(key); }
+    bool pinRefreshDue() const {
+        return hotKeys_ && maxPinnedKeys_ > 0 && hotKeys_->samples() >= nextPinRefresh_;
+    }
+    void rebuildFrontTable() const;  // Caller must hold the exclusive lock
+    void traceAccess(TraceOp op, const Key& key) const {
+        if (trace_ && trace_->sample()) traceKey(*trace_, op, hash_(key), key);
+    }
+    void unpin(const Key& key);
+
+    // Times one public call for the slow-operation recorder; inert unless one is
+    // attached. capture() runs under the table lock, the destructor records.
+    class SlowOpScope {
+    public:
+        SlowOpScope(const HybridHashTable& table, SlowOpType type) : table_(table), active_(false) {
+            if (!table.recordSlowOps_.load(std::memory_order_relaxed)) return;
+            active_ = true;
+            start_ = SlowOpRecorder::Clock::now();
+            op_ = SlowOp();
+            op_.op = type;
+        }
+        ~SlowOpScope() {
+            if (!recorder_) return;
+            auto end = SlowOpRecorder::Clock::now();
+            if (!recorder_->isSlow(start_, end)) return;
+            if (key_) op_.keyHash = HashUtils::hash(*key_);  // Only slow calls pay for the hash
+            recorder_->record(start_, end, op_);
+        }
+        SlowOpScope(const SlowOpScope&) = delete;
+        SlowOpScope& operator=(const SlowOpScope&) = delete;
+
+        // At lock acquisition: counters the call's work is measured against
+        void begin() {
+            if (!active_) return;
+            recorder_ = table_.slowOps_;
+            probesBefore_ = table_.totalProbes_;
+            displacementsBefore_ = table_.totalDisplacements_;
+            op_.mode = table_.currentMode_;
+            op_.stashSize = table_.stash_->size();
+            op_.size = table_.numElements_;
+            op_.capacity = table_.capacity_;
+        }
+        // Before the lock is released; key must outlive the scope
+        void end(const Key* key) {
+            if (!recorder_) return;
+            op_.probes = table_.totalProbes_ - probesBefore_;
+            op_.displacements = table_.totalDisplacements_ - displacementsBefore_;
+            op_.stashSize = std::max(op_.stashSize, table_.stash_->size());
+            key_ = key;
+        }
+        void resized() { op_.resized = true; }
+
+    private:
+        const HybridHashTable& table_;
+        bool active_;
+        std::shared_ptr<SlowOpRecorder> recorder_;
+        SlowOpRecorder::Clock::time_point start_;
+        SlowOp op_;
+        const Key* key_ = nullptr;
+        size_t probesBefore_ = 0;
+        size_t displacementsBefore_ = 0;
+    };
 };
 
+template <typename Key, typename Value>
+template <typename Fn>
+void HybridHashTable<Key, Value>::forEach(Fn&& fn) const {
+    std::shared_lock<TableMutex> lock(mutex_);
+    for (size_t i = 0; i < capacity_; ++i) {
+        const Slot& slot = table_[i];
+        if (slot && !isTombstone(slot)) fn(slot->first, readValue(slot->second));
+    }
+    if (currentMode_ == HashMode::Cuckoo) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            const Slot& slot = table2_[i];
+            if (slot && !isTombstone(slot)) fn(slot->first, readValue(slot->second));
+        }
+    }
+    for (const auto& item : *stash_) fn(item.first, readValue(item.second));
+}
+
+template <typename Key, typename Value>
+template <typename InputIt, typename Callback>
+void HybridHashTable<Key, Value>::lookupStream(InputIt begin, InputIt end, Callback&& callback) const {
+    std::vector<Key> keys;
+    std::vector<std::optional<Value>> results;
+    keys.reserve(STREAM_CHUNK);
+    while (begin != end) {
+        keys.clear();
+        for (; begin != end && keys.size() < STREAM_CHUNK; ++begin) keys.push_back(*begin);
+        lookupChunk(keys, results);  // Callbacks run outside the lock
+        for (size_t i = 0; i < keys.size(); ++i) callback(keys[i], std::move(results[i]));
+    }
+}
+
+// Shared-lock fast path, exclusive-lock fallback; op(Value*) performs the update and
+// returns whether it wrote, so a failed compareExchange keeps the entry's version
+template <typename Key, typename Value>
+template <typename Op>
+bool HybridHashTable<Key, Value>::updateValue(const Key& key, Op&& op) {
+    {
+        std::shared_lock<TableMutex> lock(mutex_);
+        recordAccess(key);
+        Entry* entry;
+        if (!sharedEntrySlot(key, entry)) return false;
+        if (entry) {
+            if (op(&entry->second)) publishVersion(entry, nextVersion());  // After the value, see searchVersioned
+            return true;
+        }
+    }
+    std::unique_lock<TableMutex> lock(mutex_);
+    Entry* entry = exclusiveEntrySlot(key);
+    if (!entry) return false;
+    if (op(&entry->second)) {
+        entry->version = nextVersion();
+        syncPinned(key, entry->second);
+    }
+    return true;
+}
+
+// Concurrent shared-lock writers can finish out of clock order; only ever raise the
+// version so a later write is never hidden behind an older one
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::publishVersion(Entry* entry, uint64_t version) {
+    uint64_t current = __atomic_load_n(&entry->version, __ATOMIC_RELAXED);
+    while (current < version &&
+           !__atomic_compare_exchange_n(&entry->version, &current, version, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+}
+
+template <typename Key, typename Value>
+template <typename V, typename>
+std::optional<Value> HybridHashTable<Key, Value>::fetchAdd(const Key& key, Value delta) {
+    Value previous;
+    bool found = updateValue(key, [&](Value* value) {
+        previous = __atomic_fetch_add(value, delta, __ATOMIC_ACQ_REL);
+        return true;
+    });
+    if (!found) return std::nullopt;
+    return previous;
+}
+
+template <typename Key, typename Value>
+template <typename V, typename>
+std::optional<Value> HybridHashTable<Key, Value>::exchange(const Key& key, Value desired) {
+    Value previous;
+    bool found = updateValue(key, [&](Value* value) {
+        __atomic_exchange(value, &desired, &previous, __ATOMIC_ACQ_REL);
+        return true;
+    });
+    if (!found) return std::nullopt;
+    return previous;
+}
+
+template <typename Key, typename Value>
+template <typename V, typename>
+bool HybridHashTable<Key, Value>::compareExchange(const Key& key, Value& expected, Value desired) {
+    bool swapped = false;
+    Value observed = expected;
+    bool found = updateValue(key, [&](Value* value) {
+        swapped = __atomic_compare_exchange(value, &observed, &desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+        return swapped;
+    });
+    if (found) expected = observed;
+    return swapped;
+}
+
+template <typename Key, typename Value>
+template <typename V, typename>
+std::optional<Value> HybridHashTable<Key, Value>::load(const Key& key) const {
+    std::shared_lock<TableMutex> lock(mutex_);
+    recordAccess(key);
+    return searchInternal(key);
+}
+
 #endif // HYBRID_HASH_TABLE_HPP
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef LOCK_PROFILER_HPP
+#define LOCK_PROFILER_HPP
+
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Contention counters for one lock. All zeros when profiling is compiled out.
+struct LockStats {
+    size_t exclusiveAcquisitions = 0;
+    size_t exclusiveContended = 0;   // Acquisitions that had to wait
+    uint64_t exclusiveWaitNs = 0;
+    uint64_t exclusiveHoldNs = 0;
+    uint64_t maxExclusiveWaitNs = 0;
+    size_t sharedAcquisitions = 0;
+    size_t sharedContended = 0;
+    uint64_t sharedWaitNs = 0;
+    uint64_t sharedHoldNs = 0;
+    uint64_t maxSharedWaitNs = 0;
+};
+
+#ifdef HYBRID_HASH_LOCK_PROFILING
+
+constexpr bool LOCK_PROFILING_ENABLED = true;
+
+// Drop-in std::shared_mutex replacement that records wait time, hold time and
+// contention. Uncontended acquisitions only pay for a try_lock and a clock read.
+class ProfiledSharedMutex {
+public:
+    void lock();
+    bool try_lock();
+    void unlock();
+    void lock_shared();
+    bool try_lock_shared();
+    void unlock_shared();
+
+    LockStats stats() const;
+    void resetStats();
+
+private:
+    std::shared_mutex mutex_;
+    uint64_t exclusiveSince_ = 0;  // Written only by the exclusive holder
+    std::atomic<size_t> exclusiveAcquisitions_{0};
+    std::atomic<size_t> exclusiveContended_{0};
+    std::atomic<uint64_t> exclusiveWaitNs_{0};
+    std::atomic<uint64_t> exclusiveHoldNs_{0};
+    std::atomic<uint64_t> maxExclusiveWaitNs_{0};
+    std::atomic<size_t> sharedAcquisitions_{0};
+    std::atomic<size_t> sharedContended_{0};
+    std::atomic<uint64_t> sharedWaitNs_{0};
+    std::atomic<uint64_t> sharedHoldNs_{0};
+    std::atomic<uint64_t> maxSharedWaitNs_{0};
+};
+
+using TableMutex = ProfiledSharedMutex;
+inline LockStats lockStats(const ProfiledSharedMutex& mutex) { return mutex.stats(); }
+
+#else
+
+constexpr bool LOCK_PROFILING_ENABLED = false;
+using TableMutex = std::shared_mutex;
+inline LockStats lockStats(const std::shared_mutex&) { return {}; }
+
+#endif // HYBRID_HASH_LOCK_PROFILING
+
+#endif // LOCK_PROFILER_HPP
@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file (POSIX mmap). Move-only; unmaps on
+// destruction. An empty file maps to an empty view.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);  // Prints the error and returns false on failure
+    void close();
+    void adviseRandom();  // Hint for lookup-heavy use after a sequential pass
+
+    bool isOpen() const { return open_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+};
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,61 @@
+#ifndef MAPPED_INDEX_HPP
+#define MAPPED_INDEX_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "MappedFile.hpp"
+
+// Read-only index over a memory-mapped "key,value" file (the data.csv format).
+// Instead of copying keys and values, each entry stores a 32-bit hash
+// fingerprint, the line's offset and the key and line lengths in 16 bytes;
+// lookups verify the key against the mapping and return views into it. Building
+// is one pass that counts lines and estimates distinct keys, then one hashing
+// pass, so duplicate-heavy files get a smaller table. As with loadFromFile, the first
+// line for a key wins and lines without a key or a value are skipped.
+// Immutable after build(), so concurrent find() calls need no locking.
+class MappedIndex {
+public:
+    bool build(const std::string& path);
+
+    std::optional<std::string_view> find(std::string_view key) const;  // Value view, valid while the index lives
+    bool contains(std::string_view key) const { return find(key).has_value(); }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return entries_.size(); }
+    size_t duplicates() const { return duplicates_; }    // Lines skipped because the key was already indexed
+    size_t memoryBytes() const { return entries_.capacity() * sizeof(Entry); }  // Excluding the mapping
+    const MappedFile& file() const { return file_; }
+
+private:
+    static constexpr double MAX_LOAD_FACTOR = 0.85;
+    static const uint64_t MAX_OFFSET = (uint64_t(1) << 40) - 1;  // 1 TiB
+    static const uint32_t MAX_KEY_LENGTH = (uint32_t(1) << 24) - 1;
+
+    // lineLength == 0 marks an empty slot (indexed lines are at least "k,v")
+    struct Entry {
+        uint32_t fingerprint;
+        uint32_t lineLength;
+        uint64_t offsetAndKeyLength;  // Offset in the low 40 bits, key length in the high 24
+        uint64_t offset() const { return offsetAndKeyLength & MAX_OFFSET; }
+        uint32_t keyLength() const { return static_cast<uint32_t>(offsetAndKeyLength >> 40); }
+    };
+    static_assert(sizeof(Entry) == 16, "MappedIndex entries are 16 bytes");
+
+    MappedFile file_;
+    std::vector<Entry> entries_;
+    size_t size_ = 0;
+    size_t duplicates_ = 0;
+
+    static uint64_t hashKey(std::string_view key);
+    size_t home(uint64_t hash) const;  // Multiply-shift range reduction, any capacity
+    std::string_view keyAt(const Entry& entry) const {
+        return std::string_view(file_.data() + entry.offset(), entry.keyLength());
+    }
+    bool insert(std::string_view key, uint64_t offset, size_t lineLength);
+    void regrow(size_t capacity);
+};
+
+#endif // MAPPED_INDEX_HPP
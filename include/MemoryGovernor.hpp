@@ -0,0 +1,44 @@
+#ifndef MEMORY_GOVERNOR_HPP
+#define MEMORY_GOVERNOR_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Memory budget that tables consult before allocating for growth.
+// fromCgroup() follows this process's cgroup (v2 memory.max/memory.current, or
+// v1 memory.limit_in_bytes/memory.usage_in_bytes) and its ancestors, taking the
+// tightest limit; withBudget() compares a fixed byte budget against the process
+// RSS. Usage is re-read on every query, so one governor can be shared by tables
+// and threads. A reserve fraction of the limit is kept free for everything else.
+class MemoryGovernor {
+public:
+    static MemoryGovernor fromCgroup(double reserveFraction = 0.05);
+    static MemoryGovernor withBudget(size_t budgetBytes, double reserveFraction = 0.05);
+
+    bool limited() const { return limited_; }  // False when no limit was found: everything is allowed
+    size_t limit() const;                       // Bytes; SIZE_MAX when unlimited
+    size_t usage() const;                       // Bytes currently charged against the limit
+    size_t headroom() const;                    // Limit minus usage, 0 when over; SIZE_MAX when unlimited
+    bool allows(size_t bytes) const;            // Fits in the headroom with the reserve left free
+    const std::string& source() const { return source_; }  // Where the limit came from
+
+private:
+    // One cgroup level: files holding its limit and its current usage
+    struct Level {
+        std::string limitFile;
+        std::string usageFile;
+    };
+
+    MemoryGovernor() = default;
+    static bool readBytes(const std::string& path, size_t& bytes);  // False for "max" or unreadable
+    static size_t residentBytes();
+
+    std::vector<Level> levels_;  // Empty when the budget is fixed
+    size_t budget_ = 0;
+    double reserveFraction_ = 0.0;
+    bool limited_ = false;
+    std::string source_ = "none";
+};
+
+#endif // MEMORY_GOVERNOR_HPP
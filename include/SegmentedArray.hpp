@@ -0,0 +1,190 @@
+#ifndef SEGMENTED_ARRAY_HPP
+#define SEGMENTED_ARRAY_HPP
+
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "ThreadPool.hpp"
+
+// Fixed-size array split into segments that are shared copy-on-write.
+// Copying a SegmentedArray is O(1): both copies point at the same segments,
+// and whichever side writes first gets its own copy of just that segment.
+// assign() is lazy as well: every segment starts out sharing one filled segment
+// and is materialized by its first write, so clearing costs O(size / SEGMENT_SIZE).
+// Not internally synchronized: copying and writing need exclusive access to
+// the source, which HybridHashTable guarantees through its lock.
+template <typename T>
+class SegmentedArray {
+public:
+    static constexpr size_t SEGMENT_SHIFT = 12;
+    static constexpr size_t SEGMENT_SIZE = size_t(1) << SEGMENT_SHIFT;
+    static constexpr size_t SEGMENT_MASK = SEGMENT_SIZE - 1;
+
+    SegmentedArray() : dir_(std::make_shared<Directory>()) {}
+
+    SegmentedArray(const SegmentedArray& other) : dir_(other.dir_) {
+        ++other.shareEpoch_;  // Everything the source owned is shared now
+    }
+
+    SegmentedArray& operator=(const SegmentedArray& other) {
+        dir_ = other.dir_;
+        ++other.shareEpoch_;
+        ++shareEpoch_;
+        return *this;
+    }
+
+    // Replace contents with n copies of value (previous segments stay alive for any sharers).
+    // Only one segment is filled now; the rest share it until written. When the size
+    // is unchanged and T is trivially destructible, private segments are kept as
+    // spares and refilled on first write instead of being freed and reallocated.
+    void assign(size_t n, const T& value) {
+        auto dir = std::make_shared<Directory>();
+        dir->size = n;
+        size_t count = (n + SEGMENT_MASK) >> SEGMENT_SHIFT;
+        dir->segments.reserve(count);
+        Segment fill;
+        if (n > 0) {
+            fill = allocate(std::min(SEGMENT_SIZE, n));
+            std::fill_n(fill.data, std::min(SEGMENT_SIZE, n), value);
+        }
+        dir->fill = fill.owner;
+        bool keepSpares = std::is_trivially_destructible_v<T> && n == size() && dirEpoch_ == shareEpoch_;
+        for (size_t s = 0; s < count; ++s) {
+            Segment seg = fill;
+            if (keepSpares) {
+                const Segment& old = dir_->segments[s];
+                seg.spare = owned_[s].epoch == shareEpoch_ ? old.owner : old.spare;  // Untouched: carry its spare
+            }
+            dir->segments.push_back(std::move(seg));
+        }
+        dir_ = std::move(dir);
+        ++shareEpoch_;  // Every segment is shared with the fill segment now
+        dirEpoch_ = shareEpoch_;
+        owned_.assign(count, OwnedSegment{0, nullptr});
+    }
+
+    size_t size() const { return dir_->size; }
+
+    // Reads never copy
+    const T& operator[](size_t i) const {
+        return dir_->segments[i >> SEGMENT_SHIFT].data[i & SEGMENT_MASK];
+    }
+
+    // Writes copy the directory and the touched segment if they are shared
+    T& operator[](size_t i) {
+        size_t s = i >> SEGMENT_SHIFT;
+        if (s < owned_.size() && owned_[s].epoch == shareEpoch_) {
+            return owned_[s].data[i & SEGMENT_MASK];
+        }
+        return claimSegment(s)[i & SEGMENT_MASK];
+    }
+
+    // Element i for an in-place update if its segment is already private, nullptr if a
+    // write would have to copy it first. Changes nothing, so it is safe alongside readers.
+    T* ownedSlot(size_t i) const {
+        size_t s = i >> SEGMENT_SHIFT;
+        if (s < owned_.size() && owned_[s].epoch == shareEpoch_) return owned_[s].data + (i & SEGMENT_MASK);
+        return nullptr;
+    }
+
+    // Take private copies of every shared segment now instead of on first write,
+    // spreading the copies over the pool. Segments still holding the assign() fill
+    // stay lazy. The sources are only read, so the array this one was copied from
+    // may keep writing meanwhile.
+    void detach(ThreadPool& pool) {
+        claimAll(pool, false);
+    }
+
+    // Make every segment private, fill included, so that afterwards writes to
+    // distinct elements from several threads are safe (they all take the owned path)
+    void materialize(ThreadPool& pool) {
+        claimAll(pool, true);
+    }
+
+private:
+    struct Segment {
+        T* data = nullptr;
+        std::shared_ptr<T> owner;  // Keeps data alive; use_count tells whether it is shared
+        std::shared_ptr<T> spare;  // Buffer from before the last assign(), reused by the first write
+    };
+    struct OwnedSegment {
+        uint64_t epoch;
+        T* data;
+    };
+    struct Directory {
+        std::vector<Segment> segments;
+        size_t size = 0;
+        std::shared_ptr<T> fill;  // The segment assign() shares; never written
+    };
+
+    static Segment allocate(size_t len) {
+        Segment seg;
+        seg.data = new T[len];
+        seg.owner.reset(seg.data, std::default_delete<T[]>());
+        return seg;
+    }
+
+    // Slow path: take private ownership of the directory and segment s
+    T* claimSegment(size_t s) {
+        claimDirectory();
+        return claimData(s);
+    }
+
+    void claimDirectory() {
+        if (dirEpoch_ != shareEpoch_) {
+            if (dir_.use_count() > 1) dir_ = std::make_shared<Directory>(*dir_);
+            owned_.assign(dir_->segments.size(), OwnedSegment{0, nullptr});
+            dirEpoch_ = shareEpoch_;
+        }
+    }
+
+    // Needs a claimed directory; touches only segment s, so distinct segments can be
+    // claimed concurrently
+    T* claimData(size_t s) {
+        Segment& seg = dir_->segments[s];
+        if (seg.owner.use_count() > 1) {
+            size_t len = std::min(SEGMENT_SIZE, dir_->size - (s << SEGMENT_SHIFT));
+            Segment copy;
+            if (seg.spare && seg.spare.use_count() == 1) {
+                copy.data = seg.spare.get();
+                copy.owner = std::move(seg.spare);
+            } else {
+                copy = allocate(len);
+            }
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                std::memcpy(copy.data, seg.data, len * sizeof(T));
+            } else {
+                std::copy(seg.data, seg.data + len, copy.data);
+            }
+            seg = std::move(copy);
+        }
+        owned_[s] = {shareEpoch_, seg.data};
+        return seg.data;
+    }
+
+    void claimAll(ThreadPool& pool, bool includeFill) {
+        claimDirectory();
+        std::vector<size_t> pending;
+        for (size_t s = 0; s < dir_->segments.size(); ++s) {
+            if (owned_[s].epoch == shareEpoch_) continue;
+            const Segment& seg = dir_->segments[s];
+            if (includeFill || seg.owner != dir_->fill) pending.push_back(s);
+        }
+        pool.parallelFor(0, pending.size(), 1, [this, &pending](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) claimData(pending[k]);
+        });
+    }
+
+    std::shared_ptr<Directory> dir_;
+    // A segment is known to be private while its owned epoch matches shareEpoch_;
+    // copying this array bumps shareEpoch_, which revokes all of them in O(1).
+    mutable uint64_t shareEpoch_ = 1;
+    uint64_t dirEpoch_ = 0;
+    std::vector<OwnedSegment> owned_;
+};
+
+#endif // SEGMENTED_ARRAY_HPP
@@ -0,0 +1,64 @@
+#ifndef SLOW_OP_RECORDER_HPP
+#define SLOW_OP_RECORDER_HPP
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+enum class HashMode;  // HybridHashTable.hpp
+
+enum class SlowOpType : uint8_t { Insert, Search, Remove, Resize, Update };  // Update: compareAndSet, updateIfVersion
+
+// One table call that took longer than the recorder's threshold, with the table
+// state the call saw under its lock
+struct SlowOp {
+    uint64_t timestampNs;  // When the call started, since the recorder was created
+    double durationUs;     // Whole call: lock wait, probing and any growth it triggered
+    SlowOpType op;
+    HashMode mode;
+    uint64_t keyHash;      // Unseeded HashUtils::hash, stable across reseeds; 0 for Resize
+    size_t probes;         // Robin Hood slots examined by an insert
+    size_t displacements;  // Cuckoo evictions, Robin Hood swaps, Hopscotch moves
+    size_t stashSize;
+    size_t size;
+    size_t capacity;       // Before any growth
+    bool resized;          // The call rehashed the table
+};
+
+// Flight recorder for slow table operations: keeps the last capacity calls that
+// ran longer than thresholdUs in a ring buffer. Tables time each call with two
+// clock reads and only take the recorder's lock for slow ones, so it can stay
+// attached in production. Thread-safe; one recorder can serve several tables.
+class SlowOpRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SlowOpRecorder(double thresholdUs = 1000.0, size_t capacity = 256);
+
+    bool isSlow(Clock::time_point start, Clock::time_point end) const { return end - start >= threshold_; }
+    void record(Clock::time_point start, Clock::time_point end, SlowOp op);  // Fills timestamp and duration
+
+    std::vector<SlowOp> recent() const;  // Oldest first
+    size_t recorded() const;             // Slow calls seen, including those overwritten since
+    void dump(std::ostream& out) const;  // One line per recent slow call
+    bool dumpToFile(const std::string& filename) const;  // Prints the error and returns false on failure
+    void clear();
+
+    double thresholdUs() const { return std::chrono::duration<double, std::micro>(threshold_).count(); }
+    size_t capacity() const { return capacity_; }
+
+private:
+    Clock::duration threshold_;
+    size_t capacity_;
+    Clock::time_point start_;
+    mutable std::mutex mutex_;
+    std::vector<SlowOp> ring_;
+    size_t next_;      // Ring position of the next record
+    size_t recorded_;
+};
+
+#endif // SLOW_OP_RECORDER_HPP
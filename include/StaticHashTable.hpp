@@ -0,0 +1,108 @@
+#ifndef STATIC_HASH_TABLE_HPP
+#define STATIC_HASH_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include "HashFunctions.hpp"
+#include "HopscotchProbe.hpp"
+
+// Read-only hopscotch table built entirely at compile time, e.g. keyword or
+// status code maps:
+//
+//   constexpr auto modes = makeStaticHashTable<std::string_view, HashMode>({
+//       {"cuckoo", HashMode::Cuckoo}, {"hopscotch", HashMode::Hopscotch}});
+//   const HashMode* m = modes.find(name);
+//
+// The builder tries hash seeds until every key lands in its home neighborhood,
+// so the table never needs displacement or a stash. Lookups go through the same
+// hopscotchProbe kernel as HybridHashTable. Keys are std::string_view or
+// integral/enum values; Value must be a literal type with a default constructor.
+template <typename Key, typename Value, size_t Capacity>
+class StaticHashTable {
+public:
+    static constexpr size_t HOP_RANGE = 32;
+    static constexpr size_t MAX_SEEDS = 256;
+
+    template <size_t N>
+    constexpr explicit StaticHashTable(const std::pair<Key, Value> (&entries)[N]) {
+        static_assert(N <= Capacity, "StaticHashTable: more entries than slots");
+        for (size_t attempt = 0; attempt < MAX_SEEDS; ++attempt) {
+            if (build(entries, attempt * 0x9e3779b97f4a7c15ULL)) return;
+        }
+        // A throw is not a constant expression, so in a constexpr build this is a compile error
+        throw std::logic_error("StaticHashTable: no seed places every key in its neighborhood (duplicate key?)");
+    }
+
+    constexpr const Value* find(const Key& key) const {
+        size_t baseIndex = HashUtils::staticHash(key, seed_) % Capacity;
+        size_t start = neighborhoodStart(baseIndex);
+        size_t found = hopscotchProbe(hopInfo_[baseIndex], start, neighborhoodEnd(start), HOP_RANGE,
+                                      [&](size_t i) { return slots_[i].used && slots_[i].key == key; });
+        return found != HOPSCOTCH_NOT_FOUND ? &slots_[found].value : nullptr;
+    }
+
+    constexpr bool contains(const Key& key) const { return find(key) != nullptr; }
+    constexpr size_t size() const { return size_; }
+    constexpr size_t capacity() const { return Capacity; }
+    constexpr uint64_t seed() const { return seed_; }
+
+private:
+    struct Slot {
+        Key key{};
+        Value value{};
+        bool used = false;
+    };
+
+    static constexpr size_t neighborhoodStart(size_t index) { return (index / HOP_RANGE) * HOP_RANGE; }
+    static constexpr size_t neighborhoodEnd(size_t start) {
+        return start + HOP_RANGE < Capacity ? start + HOP_RANGE : Capacity;
+    }
+
+    template <size_t N>
+    constexpr bool build(const std::pair<Key, Value> (&entries)[N], uint64_t seed) {
+        slots_ = {};
+        hopInfo_ = {};
+        seed_ = seed;
+        size_ = 0;
+        for (size_t e = 0; e < N; ++e) {
+            size_t baseIndex = HashUtils::staticHash(entries[e].first, seed) % Capacity;
+            size_t start = neighborhoodStart(baseIndex);
+            size_t end = neighborhoodEnd(start);
+            size_t target = end;
+            for (size_t i = start; i < end; ++i) {
+                if (slots_[i].used && slots_[i].key == entries[e].first) return false;  // Duplicate key
+                if (!slots_[i].used && target == end) target = i;
+            }
+            if (target == end) return false;
+            slots_[target].key = entries[e].first;
+            slots_[target].value = entries[e].second;
+            slots_[target].used = true;
+            hopInfo_[baseIndex] |= 1U << (target - start);
+            ++size_;
+        }
+        return true;
+    }
+
+    std::array<Slot, Capacity> slots_{};
+    std::array<uint32_t, Capacity> hopInfo_{};
+    uint64_t seed_ = 0;
+    size_t size_ = 0;
+};
+
+// Twice the entry count rounded up to a power of two
+constexpr size_t staticTableCapacity(size_t entries) {
+    size_t capacity = 1;
+    while (capacity < entries * 2) capacity <<= 1;
+    return capacity;
+}
+
+template <typename Key, typename Value, size_t N>
+constexpr StaticHashTable<Key, Value, staticTableCapacity(N)> makeStaticHashTable(const std::pair<Key, Value> (&entries)[N]) {
+    return StaticHashTable<Key, Value, staticTableCapacity(N)>(entries);
+}
+
+#endif // STATIC_HASH_TABLE_HPP
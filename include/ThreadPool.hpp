@@ -0,0 +1,73 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool shared by the library's parallel operations (deep clone,
+// parallel rehash, multi-file loading). Each worker owns a deque: it pushes and
+// pops its own tasks at the back and idle workers steal from the front of others.
+// Tasks submitted from outside the pool are spread round-robin. The thread calling
+// parallelFor() works through that loop's own chunks and never runs unrelated
+// tasks, so it may hold a lock, and nested parallel calls from inside a task
+// cannot deadlock. Tasks must not throw.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(size_t threads = 0, bool pinThreads = false);  // 0: hardware concurrency
+    ~ThreadPool();  // Runs what is queued, then joins
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+
+    // Call fn(begin, end) over [begin, end) split into chunks of at least grain
+    // items, and return when all chunks are done. The calling thread takes part.
+    void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    // Run queued tasks on the calling thread until done() returns true. For waiting
+    // on submitted work without blocking a worker the work may be queued behind.
+    // Any queued task may run here, so do not call it while holding a lock those
+    // tasks could need.
+    void helpUntil(const std::function<bool()>& done);
+
+    size_t size() const { return workers_.size(); }
+    size_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+    // The pool library features use when the caller passes none. Created on first
+    // use with hardware concurrency threads; setDefault() swaps in a caller's pool
+    // (operations already running keep the one they started with).
+    static std::shared_ptr<ThreadPool> defaultPool();
+    static void setDefault(std::shared_ptr<ThreadPool> pool);
+
+private:
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> queued_;
+    std::atomic<size_t> nextQueue_;
+    std::atomic<size_t> steals_;
+    bool stopping_;
+
+    void run(size_t index, bool pin);
+    bool runOne(size_t home);  // Own deque first, then steal; false if nothing was found
+    bool popBack(Worker& worker, Task& task);
+    bool popFront(Worker& worker, Task& task);
+    size_t currentWorker() const;  // Index of the calling worker, or size() outside the pool
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,90 @@
+#ifndef TRACE_RECORDER_HPP
+#define TRACE_RECORDER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+// Table operations captured in a workload trace
+// Update: a write to an existing key (compareAndSet, updateIfVersion, insertOrAssign on a present key)
+enum class TraceOp : uint8_t { Insert = 0, Search = 1, Remove = 2, Update = 3 };
+
+struct TraceRecord {
+    uint64_t timestampNs;  // Since the recorder was created
+    uint64_t keyHash;
+    TraceOp op;
+    std::string key;       // Empty when the trace was recorded without keys
+};
+
+// Low-overhead binary trace writer. Each thread appends to its own fixed-size
+// buffer and only takes the file lock when that buffer fills up; a record larger
+// than the buffer goes straight to the file. A thread's buffers are written out
+// and released when the thread exits.
+//
+// File layout: "HHTRACE1", then per record: u64 timestamp, u64 hash, u8 op,
+// u32 key length, key bytes (native byte order).
+class TraceRecorder {
+public:
+    // Records every sampleRate-th operation of each thread; recordKeys=false logs only hashes
+    TraceRecorder(const std::string& filename, size_t sampleRate = 1, bool recordKeys = true,
+                  size_t bufferBytes = size_t(1) << 20);
+    ~TraceRecorder();  // Flushes all thread buffers
+
+    bool isOpen() const { return file_ != nullptr; }
+    bool recordsKeys() const { return recordKeys_; }
+
+    // Cheap per-thread sampling check; call record() only when it returns true
+    bool sample() const {
+        thread_local size_t tick = 0;
+        return ++tick % sampleRate_ == 0;
+    }
+    void record(TraceOp op, uint64_t keyHash, const char* key, size_t keyLength);
+    void flush();
+    size_t recorded() const { return recorded_.load(std::memory_order_relaxed); }
+
+    static bool readTrace(const std::string& filename, std::vector<TraceRecord>& records);
+
+private:
+    struct ThreadBuffer {
+        std::mutex mutex;  // Uncontended except while flush() drains it
+        std::vector<char> data;
+        size_t used = 0;
+    };
+
+    struct ThreadBuffers;  // This thread's buffers, one per live recorder; defined in the .cpp
+    static thread_local ThreadBuffers threadBuffers_;
+
+    ThreadBuffer& localBuffer();
+    void writeOut(ThreadBuffer& buffer);  // Caller holds buffer.mutex
+    void writeBytes(const char* data, size_t size);
+    void releaseBuffer(ThreadBuffer* buffer);  // Writes it out and drops it from the registry
+
+    uint64_t id_;
+    std::FILE* file_;
+    size_t sampleRate_;
+    bool recordKeys_;
+    size_t bufferBytes_;
+    std::chrono::steady_clock::time_point start_;
+    std::mutex fileMutex_;
+    std::mutex registryMutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::atomic<size_t> recorded_;
+};
+
+// Key encoding for traces: strings keep their bytes, other keys are logged by hash only
+inline void traceKey(TraceRecorder& recorder, TraceOp op, uint64_t keyHash, const std::string& key) {
+    recorder.record(op, keyHash, key.data(), key.size());
+}
+
+template <typename Key>
+void traceKey(TraceRecorder& recorder, TraceOp op, uint64_t keyHash, const Key&) {
+    recorder.record(op, keyHash, nullptr, 0);
+}
+
+#endif // TRACE_RECORDER_HPP
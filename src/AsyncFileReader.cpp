@@ -0,0 +1,265 @@
+#include "AsyncFileReader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ASYNC_READER_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace {
+    // Read until wanted bytes, end of file or an error; returns bytes read or -errno
+    long preadFull(int fd, char* buffer, size_t wanted, size_t offset) {
+        size_t got = 0;
+        while (got < wanted) {
+            ssize_t n = pread(fd, buffer + got, wanted - got, static_cast<off_t>(offset + got));
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return -errno;
+            if (n == 0) break;
+            got += static_cast<size_t>(n);
+        }
+        return static_cast<long>(got);
+    }
+}
+
+#ifdef ASYNC_READER_IO_URING
+// The three shared mappings of an io_uring instance. Only the reader's thread
+// touches the submission side; the kernel publishes completions through cqTail.
+struct AsyncFileReader::Ring {
+    int fd = -1;
+    void* sqMap = MAP_FAILED;
+    size_t sqMapBytes = 0;
+    void* cqMap = MAP_FAILED;
+    size_t cqMapBytes = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesBytes = 0;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    std::unique_ptr<iovec[]> iovecs;  // One per slot: READV needs them alive until completion
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesBytes);
+        if (cqMap != MAP_FAILED && cqMap != sqMap) munmap(cqMap, cqMapBytes);
+        if (sqMap != MAP_FAILED) munmap(sqMap, sqMapBytes);
+        if (fd >= 0) close(fd);
+    }
+
+    // False if the kernel refuses (ENOSYS before 5.1, EPERM under seccomp or sysctl)
+    bool setup(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) return false;
+        sqMapBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqMapBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sqMapBytes = cqMapBytes = std::max(sqMapBytes, cqMapBytes);
+        sqMap = mmap(nullptr, sqMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqMap == MAP_FAILED) return false;
+        cqMap = single ? sqMap
+                       : mmap(nullptr, cqMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqMap == MAP_FAILED) return false;
+        sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(
+            mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) return false;
+
+        char* sq = static_cast<char*>(sqMap);
+        char* cq = static_cast<char*>(cqMap);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        iovecs.reset(new iovec[entries]);
+        return true;
+    }
+
+    int enter(unsigned toSubmit, unsigned minComplete) {
+        unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+};
+#else
+struct AsyncFileReader::Ring {};
+#endif
+
+AsyncFileReader::AsyncFileReader(size_t blockBytes, size_t queueDepth, ReadBackend backend)
+    : blockBytes_(std::max<size_t>(blockBytes, 4096)), queueDepth_(std::max<size_t>(queueDepth, 1)),
+      slots_(new Slot[queueDepth_]), issued_(0), completed_(0), depthSamples_(0), depthSum_(0.0) {
+    for (size_t i = 0; i < queueDepth_; ++i) slots_[i].buffer.reset(new char[blockBytes_]);
+#ifdef ASYNC_READER_IO_URING
+    if (backend == ReadBackend::IoUring) {
+        ring_ = std::make_unique<Ring>();
+        if (!ring_->setup(static_cast<unsigned>(queueDepth_))) ring_.reset();
+    }
+#else
+    (void)backend;
+#endif
+    if (!ring_) pool_ = ThreadPool::defaultPool();
+}
+
+AsyncFileReader::~AsyncFileReader() = default;
+
+bool AsyncFileReader::readFile(const std::string& path, const BlockFn& fn) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open file " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        std::cerr << "Error: Cannot stat " << path << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);  // Larger kernel read-ahead behind our own
+#endif
+
+    auto start = std::chrono::steady_clock::now();
+    size_t size = static_cast<size_t>(info.st_size);
+    size_t blocks = (size + blockBytes_ - 1) / blockBytes_;
+    size_t submitted = 0, delivered = 0;
+    bool ok = true;
+    while (delivered < blocks) {
+        // Refill the window: every slot not being parsed holds a read in flight
+        size_t batch = 0;
+        for (; submitted < blocks && submitted - delivered < queueDepth_; ++submitted, ++batch) {
+            Slot& slot = slots_[submitted % queueDepth_];
+            slot.offset = submitted * blockBytes_;
+            slot.wanted = std::min(blockBytes_, size - slot.offset);
+            submit(fd, submitted % queueDepth_);
+        }
+        if (batch > 0) flush(batch);
+
+        Slot& slot = slots_[delivered % queueDepth_];
+        waitFor(slot);
+        if (slot.result >= 0 && static_cast<size_t>(slot.result) < slot.wanted) {
+            // Short read: finish the block synchronously
+            long rest = preadFull(fd, slot.buffer.get() + slot.result, slot.wanted - slot.result, slot.offset + slot.result);
+            slot.result = rest < 0 ? rest : slot.result + rest;
+        }
+        if (slot.result < 0 || static_cast<size_t>(slot.result) < slot.wanted) {
+            std::cerr << "Error: Cannot read " << path << " at offset " << slot.offset << ": "
+                      << (slot.result < 0 ? std::strerror(static_cast<int>(-slot.result)) : "file shrank") << "\n";
+            ok = false;
+            break;
+        }
+        fn(slot.buffer.get(), slot.wanted);
+        delivered++;
+        stats_.reads++;
+        stats_.bytes += slot.wanted;
+    }
+    // Reads still in flight write into our buffers and use fd: wait them out
+    for (size_t i = delivered + 1; i < submitted; ++i) waitFor(slots_[i % queueDepth_]);
+    ::close(fd);
+
+    stats_.files++;
+    stats_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats_.meanQueueDepth = depthSamples_ > 0 ? depthSum_ / depthSamples_ : 0.0;
+    return ok;
+}
+
+void AsyncFileReader::submit(int fd, size_t index) {
+    Slot& slot = slots_[index];
+    slot.done.store(false, std::memory_order_relaxed);
+    issued_++;
+#ifdef ASYNC_READER_IO_URING
+    if (ring_) {
+        unsigned tail = *ring_->sqTail;
+        unsigned entry = tail & *ring_->sqMask;
+        ring_->iovecs[index].iov_base = slot.buffer.get();
+        ring_->iovecs[index].iov_len = slot.wanted;
+        io_uring_sqe& sqe = ring_->sqes[entry];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;  // READV rather than READ: available since 5.1
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(&ring_->iovecs[index]);
+        sqe.len = 1;
+        sqe.off = slot.offset;
+        sqe.user_data = index;
+        ring_->sqArray[entry] = entry;
+        __atomic_store_n(ring_->sqTail, tail + 1, __ATOMIC_RELEASE);  // Publish the entry to the kernel
+        return;
+    }
+#endif
+    pool_->submit([this, fd, &slot] {
+        slot.result = preadFull(fd, slot.buffer.get(), slot.wanted, slot.offset);
+        completed_.fetch_add(1, std::memory_order_relaxed);
+        slot.done.store(true, std::memory_order_release);
+    });
+}
+
+void AsyncFileReader::flush(size_t count) {
+#ifdef ASYNC_READER_IO_URING
+    if (ring_) {
+        for (size_t started = 0; started < count;) {
+            int n = ring_->enter(static_cast<unsigned>(count - started), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;  // Left queued: the next enter() retries them
+            started += static_cast<size_t>(n);
+        }
+    }
+#endif
+    (void)count;
+    size_t inFlight = issued_ - completed_.load(std::memory_order_relaxed);
+    stats_.maxQueueDepth = std::max(stats_.maxQueueDepth, inFlight);
+    depthSum_ += static_cast<double>(inFlight);
+    depthSamples_++;
+}
+
+void AsyncFileReader::waitFor(Slot& slot) {
+    if (ring_) {
+        while (!slot.done.load(std::memory_order_acquire)) reap(true);
+        return;
+    }
+    // The read may be queued behind this thread if it is a pool worker. Helping can run
+    // any pool task here, which is why readFile must not be called holding a lock.
+    pool_->helpUntil([&slot] { return slot.done.load(std::memory_order_acquire); });
+}
+
+void AsyncFileReader::reap(bool wait) {
+#ifdef ASYNC_READER_IO_URING
+    // Also submits entries an earlier enter() left queued
+    if (wait && ring_->enter(static_cast<unsigned>(queueDepth_), 1) < 0 && errno != EINTR && errno != EAGAIN &&
+        errno != EBUSY) {
+        int error = errno;
+        std::cerr << "Error: io_uring_enter failed: " << std::strerror(error) << "\n";
+        for (size_t i = 0; i < queueDepth_; ++i) {  // Fail what is pending rather than wait forever
+            if (slots_[i].done.load(std::memory_order_relaxed)) continue;
+            slots_[i].result = -error;
+            slots_[i].done.store(true, std::memory_order_release);
+        }
+        return;
+    }
+    unsigned head = *ring_->cqHead;
+    unsigned tail = __atomic_load_n(ring_->cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = ring_->cqes[head & *ring_->cqMask];
+        Slot& slot = slots_[cqe.user_data];
+        slot.result = cqe.res;
+        completed_.fetch_add(1, std::memory_order_relaxed);
+        slot.done.store(true, std::memory_order_release);
+    }
+    __atomic_store_n(ring_->cqHead, head, __ATOMIC_RELEASE);  // Hand the entries back
+#else
+    (void)wait;
+#endif
+}
@@ -0,0 +1,112 @@
+#include "Benchmark.hpp"
+#include "StaticHashTable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <unordered_set>
+
+const char* hashModeName(HashMode mode) {
+    switch (mode) {
+        case HashMode::Cuckoo: return "Cuckoo";
+        case HashMode::Hopscotch: return "Hopscotch";
+        case HashMode::RobinHood: return "RobinHood";
+    }
+    return "Unknown";
+}
+
+bool parseHashMode(const std::string& name, HashMode& mode) {
+    static constexpr auto modes = makeStaticHashTable<std::string_view, HashMode>({
+        {"cuckoo", HashMode::Cuckoo},
+        {"hopscotch", HashMode::Hopscotch},
+        {"robinhood", HashMode::RobinHood},
+        {"robin_hood", HashMode::RobinHood},
+    });
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    const HashMode* found = modes.find(lower);
+    if (!found) return false;
+    mode = *found;
+    return true;
+}
+
+namespace {
+    const size_t STASH_SAMPLE_INTERVAL = 4096;
+
+    double percentileUs(std::vector<uint64_t>& latenciesNs, double fraction) {
+        if (latenciesNs.empty()) return 0.0;
+        size_t index = std::min(latenciesNs.size() - 1, static_cast<size_t>(fraction * latenciesNs.size()));
+        std::nth_element(latenciesNs.begin(), latenciesNs.begin() + index, latenciesNs.end());
+        return latenciesNs[index] / 1e3;
+    }
+}
+
+BenchmarkResult replayTrace(HybridHashTable<std::string, std::string>& table, const std::vector<TraceRecord>& trace, bool paced) {
+    BenchmarkResult result;
+    if (trace.empty()) return result;
+
+    // Materialize keys up front so key construction is not timed
+    std::vector<std::string> keys;
+    keys.reserve(trace.size());
+    for (const auto& record : trace) {
+        keys.push_back(record.key.empty() ? "h" + std::to_string(record.keyHash) : record.key);
+    }
+
+    std::vector<uint64_t> latenciesNs;
+    latenciesNs.reserve(trace.size());
+    uint64_t firstTimestamp = trace.front().timestampNs;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < trace.size(); ++i) {
+        if (paced) std::this_thread::sleep_until(start + std::chrono::nanoseconds(trace[i].timestampNs - firstTimestamp));
+        auto opStart = std::chrono::steady_clock::now();
+        bool hit = false;
+        switch (trace[i].op) {
+            case TraceOp::Insert: hit = table.insert(keys[i], keys[i]); result.inserts++; break;
+            case TraceOp::Search: hit = table.search(keys[i]).has_value(); result.searches++; break;
+            case TraceOp::Remove: hit = table.remove(keys[i]); result.removes++; break;
+            // Replayed values are the keys, so this rewrites a present key under the exclusive lock
+            case TraceOp::Update: hit = table.compareAndSet(keys[i], keys[i], keys[i]); result.updates++; break;
+        }
+        auto opEnd = std::chrono::steady_clock::now();
+        latenciesNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(opEnd - opStart).count());
+        result.hits += hit;
+        if (i % STASH_SAMPLE_INTERVAL == 0) {
+            result.peakStashSize = std::max(result.peakStashSize, table.stats().stashSize);
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    result.operations = trace.size();
+    result.opsPerSec = result.seconds > 0 ? result.operations / result.seconds : 0.0;
+    result.p50Us = percentileUs(latenciesNs, 0.50);
+    result.p99Us = percentileUs(latenciesNs, 0.99);
+    result.p999Us = percentileUs(latenciesNs, 0.999);
+    result.maxUs = *std::max_element(latenciesNs.begin(), latenciesNs.end()) / 1e3;
+    auto stats = table.stats();
+    result.peakStashSize = std::max(result.peakStashSize, stats.stashSize);
+    result.collisionRate = stats.totalInsertions ? static_cast<double>(stats.totalCollisions) / stats.totalInsertions : 0.0;
+    return result;
+}
+
+std::vector<TraceRecord> syntheticTrace(const std::vector<std::string>& keys) {
+    std::vector<TraceRecord> trace;
+    trace.reserve(keys.size() * 3);
+    auto add = [&trace](TraceOp op, const std::string& key) {
+        trace.push_back({trace.size(), HashUtils::hash(key), op, key});
+    };
+    for (const auto& key : keys) add(TraceOp::Insert, key);
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> distinct;
+    for (const auto& key : keys) {
+        if (seen.insert(key).second) distinct.push_back(key);
+    }
+    for (const auto& key : distinct) add(TraceOp::Search, key);
+    for (const auto& key : distinct) add(TraceOp::Remove, key);
+    return trace;
+}
+
+void printBenchmarkResult(const std::string& label, const BenchmarkResult& r, std::ostream& out) {
+    out << label << ": " << r.operations << " ops (" << r.inserts << " inserts, " << r.searches << " searches, "
+        << r.removes << " removes, " << r.updates << " updates, " << r.hits << " hits) in " << r.seconds << "s (" << r.opsPerSec << " ops/sec)\n";
+    out << "  latency us: p50 " << r.p50Us << ", p99 " << r.p99Us << ", p99.9 " << r.p999Us << ", max " << r.maxUs << "\n";
+}
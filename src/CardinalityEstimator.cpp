@@ -0,0 +1,93 @@
+#include "CardinalityEstimator.hpp"
+#include "CpuDispatch.hpp"
+#include "HashFunctions.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+HyperLogLog::HyperLogLog(unsigned precision)
+    : precision_(std::min(std::max(precision, 4u), 18u)), registers_(size_t(1) << precision_, 0) {}
+
+void HyperLogLog::add(uint64_t hash) {
+    size_t index = hash >> (64 - precision_);
+    // Rank of the first set bit in the remaining bits; the guard bit caps it
+    uint64_t rest = (hash << precision_) | (uint64_t(1) << (precision_ - 1));
+    uint8_t rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    if (rank > registers_[index]) registers_[index] = rank;
+}
+
+void HyperLogLog::addKey(std::string_view key) {
+    add(HashUtils::mix(std::hash<std::string_view>{}(key)));
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision_ != precision_) return;
+    for (size_t i = 0; i < registers_.size(); ++i) registers_[i] = std::max(registers_[i], other.registers_[i]);
+}
+
+void HyperLogLog::clear() {
+    std::fill(registers_.begin(), registers_.end(), 0);
+}
+
+size_t HyperLogLog::estimate() const {
+    double m = static_cast<double>(registers_.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t r : registers_) {
+        sum += std::ldexp(1.0, -r);
+        if (r == 0) zeros++;
+    }
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double raw = alpha * m * m / sum;
+    // Small range: linear counting is more accurate while registers are still empty
+    if (raw <= 2.5 * m && zeros > 0) raw = m * std::log(m / zeros);
+    return static_cast<size_t>(raw + 0.5);
+}
+
+double HyperLogLog::relativeError() const {
+    return 1.04 / std::sqrt(static_cast<double>(registers_.size()));
+}
+
+namespace {
+    bool addFileKeys(const std::string& filename, HyperLogLog& hll) {
+        MappedFile file;
+        if (!file.open(filename)) return false;
+        const char* data = file.data();
+        size_t length = file.size();
+        for (size_t pos = 0; pos < length;) {
+            size_t lineLength = CpuDispatch::findByte(data + pos, length - pos, '\n');
+            if (lineLength > 0) hll.addKey(std::string_view(data + pos, CpuDispatch::findByte(data + pos, lineLength, ',')));
+            pos += lineLength + 1;
+        }
+        return true;
+    }
+}
+
+bool estimateDistinctKeys(const std::string& filename, size_t& estimate, double* relativeError) {
+    HyperLogLog hll;
+    if (!addFileKeys(filename, hll)) return false;
+    estimate = hll.estimate();
+    if (relativeError) *relativeError = hll.relativeError();
+    return true;
+}
+
+bool estimateDistinctKeys(const std::vector<std::string>& filenames, size_t& estimate, double* relativeError) {
+    std::vector<HyperLogLog> sketches(filenames.size());
+    std::vector<char> mapped(filenames.size(), 0);
+    ThreadPool::defaultPool()->parallelFor(0, filenames.size(), 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) mapped[i] = addFileKeys(filenames[i], sketches[i]);
+    });
+    HyperLogLog hll;
+    bool any = false;
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        if (!mapped[i]) continue;
+        hll.merge(sketches[i]);
+        any = true;
+    }
+    if (!any) return false;
+    estimate = hll.estimate();
+    if (relativeError) *relativeError = hll.relativeError();
+    return true;
+}
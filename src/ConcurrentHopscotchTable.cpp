@@ -0,0 +1,259 @@
+#include "ConcurrentHopscotchTable.hpp"
+#include "EpochReclamation.hpp"
+#include "HopscotchProbe.hpp"
+#include <algorithm>
+#include <string>
+
+template <typename Key, typename Value>
+ConcurrentHopscotchTable<Key, Value>::BucketArray::BucketArray(size_t capacity)
+    : capacity(capacity), buckets(new Bucket[capacity + ADD_RANGE]),
+      lockCount((capacity + ADD_RANGE + LOCK_STRIPE - 1) / LOCK_STRIPE), locks(new std::mutex[lockCount]) {}
+
+template <typename Key, typename Value>
+ConcurrentHopscotchTable<Key, Value>::ConcurrentHopscotchTable(size_t initialCapacity)
+    : array_(new BucketArray(std::max<size_t>(initialCapacity, 1))), size_(0), searchRetries_(0),
+      lockedSearches_(0), displacements_(0), resizes_(0), failedInserts_(0) {}
+
+// Caller guarantees no concurrent operations
+template <typename Key, typename Value>
+ConcurrentHopscotchTable<Key, Value>::~ConcurrentHopscotchTable() {
+    BucketArray* array = array_.load();
+    for (size_t i = 0; i < array->capacity + ADD_RANGE; ++i) delete array->buckets[i].node.load();
+    delete array;
+}
+
+template <typename Key, typename Value>
+bool ConcurrentHopscotchTable<Key, Value>::insert(const Key& key, const Value& value) {
+    size_t hash = HashUtils::hash(key);
+    size_t growths = 0;
+    for (;;) {
+        Epoch::Guard guard;
+        BucketArray* array = array_.load(std::memory_order_acquire);
+        size_t home = hash % array->capacity;
+        size_t last = home + ADD_RANGE - 1;
+        lockRange(array, home, last);
+        if (array_.load(std::memory_order_acquire) != array) {  // Resized while we waited
+            unlockRange(array, home, last);
+            continue;
+        }
+        if (findNode(array, home, hash, key)) {
+            unlockRange(array, home, last);
+            return false;
+        }
+
+        size_t freeBucket = makeRoom(array, home);
+        if (freeBucket != HOPSCOTCH_NOT_FOUND) {
+            array->buckets[freeBucket].node.store(new Node{hash, key, value}, std::memory_order_release);
+            array->buckets[home].hopInfo.fetch_or(1U << (freeBucket - home), std::memory_order_acq_rel);
+            size_.fetch_add(1, std::memory_order_relaxed);
+            unlockRange(array, home, last);
+            return true;
+        }
+        bool saturated = sameHashNeighborhood(array, home, hash);
+        unlockRange(array, home, last);
+        if (saturated || ++growths > MAX_GROWTH_ATTEMPTS || !resize(array, hash)) {
+            failedInserts_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+}
+
+template <typename Key, typename Value>
+bool ConcurrentHopscotchTable<Key, Value>::remove(const Key& key) {
+    size_t hash = HashUtils::hash(key);
+    for (;;) {
+        Epoch::Guard guard;
+        BucketArray* array = array_.load(std::memory_order_acquire);
+        size_t home = hash % array->capacity;
+        size_t last = home + HOP_RANGE - 1;
+        lockRange(array, home, last);
+        if (array_.load(std::memory_order_acquire) != array) {
+            unlockRange(array, home, last);
+            continue;
+        }
+        size_t bucket;
+        Node* node = findNode(array, home, hash, key, &bucket);
+        if (node) {
+            array->buckets[home].hopInfo.fetch_and(~(1U << (bucket - home)), std::memory_order_acq_rel);
+            array->buckets[bucket].node.store(nullptr, std::memory_order_release);
+            size_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        unlockRange(array, home, last);
+        if (node) Epoch::retire(node);
+        return node != nullptr;
+    }
+}
+
+template <typename Key, typename Value>
+std::optional<Value> ConcurrentHopscotchTable<Key, Value>::search(const Key& key) const {
+    size_t hash = HashUtils::hash(key);
+    Epoch::Guard guard;
+    BucketArray* array = array_.load(std::memory_order_acquire);
+    size_t home = hash % array->capacity;
+    const Bucket& bucket = array->buckets[home];
+    for (size_t attempt = 0; attempt < MAX_READ_RETRIES; ++attempt) {
+        uint32_t timestamp = bucket.timestamp.load(std::memory_order_acquire);
+        if (Node* node = findNode(array, home, hash, key)) return node->value;
+        // A miss only counts if none of this bucket's entries moved meanwhile
+        if (bucket.timestamp.load(std::memory_order_acquire) == timestamp) return std::nullopt;
+        searchRetries_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Displacements keep racing us: the home stripe lock excludes them
+    lockedSearches_.fetch_add(1, std::memory_order_relaxed);
+    lockRange(array, home, home);
+    Node* node = findNode(array, home, hash, key);
+    std::optional<Value> result = node ? std::optional<Value>(node->value) : std::nullopt;
+    unlockRange(array, home, home);
+    return result;
+}
+
+template <typename Key, typename Value>
+size_t ConcurrentHopscotchTable<Key, Value>::capacity() const {
+    Epoch::Guard guard;
+    return array_.load(std::memory_order_acquire)->capacity;
+}
+
+template <typename Key, typename Value>
+double ConcurrentHopscotchTable<Key, Value>::loadFactor() const {
+    return static_cast<double>(size()) / capacity();
+}
+
+template <typename Key, typename Value>
+typename ConcurrentHopscotchTable<Key, Value>::Stats ConcurrentHopscotchTable<Key, Value>::stats() const {
+    Stats s;
+    s.size = size();
+    s.capacity = capacity();
+    s.searchRetries = searchRetries_.load(std::memory_order_relaxed);
+    s.lockedSearches = lockedSearches_.load(std::memory_order_relaxed);
+    s.displacements = displacements_.load(std::memory_order_relaxed);
+    s.resizes = resizes_.load(std::memory_order_relaxed);
+    s.failedInserts = failedInserts_.load(std::memory_order_relaxed);
+    return s;
+}
+
+// Stripes are always taken in ascending order, so overlapping ranges cannot deadlock
+template <typename Key, typename Value>
+void ConcurrentHopscotchTable<Key, Value>::lockRange(BucketArray* array, size_t first, size_t last) {
+    for (size_t s = first / LOCK_STRIPE; s <= last / LOCK_STRIPE; ++s) array->locks[s].lock();
+}
+
+template <typename Key, typename Value>
+void ConcurrentHopscotchTable<Key, Value>::unlockRange(BucketArray* array, size_t first, size_t last) {
+    for (size_t s = last / LOCK_STRIPE + 1; s-- > first / LOCK_STRIPE;) array->locks[s].unlock();
+}
+
+template <typename Key, typename Value>
+typename ConcurrentHopscotchTable<Key, Value>::Node* ConcurrentHopscotchTable<Key, Value>::findNode(
+    const BucketArray* array, size_t home, size_t hash, const Key& key, size_t* bucket) {
+    Node* found = nullptr;
+    size_t index = hopscotchProbe(array->buckets[home].hopInfo.load(std::memory_order_acquire), home,
+                                  home + HOP_RANGE, HOP_RANGE, [&](size_t i) {
+                                      Node* node = array->buckets[i].node.load(std::memory_order_acquire);
+                                      if (!node || node->hash != hash || !(node->key == key)) return false;
+                                      found = node;
+                                      return true;
+                                  });
+    if (bucket) *bucket = index;
+    return found;
+}
+
+// Move some entry into freeBucket from a bucket closer to its home; returns the bucket
+// that became free. Readers see the entry in both places before the old one is cleared,
+// and the timestamp bump in between tells a reader that missed it to look again.
+template <typename Key, typename Value>
+size_t ConcurrentHopscotchTable<Key, Value>::findCloserFreeBucket(BucketArray* array, size_t freeBucket) {
+    for (size_t home = freeBucket - (HOP_RANGE - 1); home < freeBucket; ++home) {
+        Bucket& homeBucket = array->buckets[home];
+        uint32_t hopInfo = homeBucket.hopInfo.load(std::memory_order_relaxed);
+        for (size_t i = 0; home + i < freeBucket; ++i) {
+            if (!(hopInfo & (1U << i))) continue;
+            size_t from = home + i;
+            Node* node = array->buckets[from].node.load(std::memory_order_relaxed);
+            array->buckets[freeBucket].node.store(node, std::memory_order_release);
+            homeBucket.hopInfo.fetch_or(1U << (freeBucket - home), std::memory_order_acq_rel);
+            homeBucket.timestamp.fetch_add(1, std::memory_order_acq_rel);
+            homeBucket.hopInfo.fetch_and(~(1U << i), std::memory_order_acq_rel);
+            array->buckets[from].node.store(nullptr, std::memory_order_release);
+            displacements_.fetch_add(1, std::memory_order_relaxed);
+            return from;
+        }
+    }
+    return HOPSCOTCH_NOT_FOUND;
+}
+
+// A free bucket in home's neighborhood, moving entries closer if the nearest free
+// one within ADD_RANGE is too far; caller owns the stripes of [home, home + ADD_RANGE)
+template <typename Key, typename Value>
+size_t ConcurrentHopscotchTable<Key, Value>::makeRoom(BucketArray* array, size_t home) {
+    size_t freeBucket = HOPSCOTCH_NOT_FOUND;
+    for (size_t i = home; i < home + ADD_RANGE; ++i) {
+        if (!array->buckets[i].node.load(std::memory_order_relaxed)) {
+            freeBucket = i;
+            break;
+        }
+    }
+    while (freeBucket != HOPSCOTCH_NOT_FOUND && freeBucket - home >= HOP_RANGE) {
+        freeBucket = findCloserFreeBucket(array, freeBucket);
+    }
+    return freeBucket;
+}
+
+// The whole neighborhood holds entries with this full hash: they share a home at
+// every capacity, so no resize can make room for another
+template <typename Key, typename Value>
+bool ConcurrentHopscotchTable<Key, Value>::sameHashNeighborhood(const BucketArray* array, size_t home, size_t hash) {
+    uint32_t hopInfo = array->buckets[home].hopInfo.load(std::memory_order_relaxed);
+    if (hopInfo != UINT32_MAX) return false;
+    for (size_t i = home; i < home + HOP_RANGE; ++i) {
+        if (array->buckets[i].node.load(std::memory_order_relaxed)->hash != hash) return false;
+    }
+    return true;
+}
+
+template <typename Key, typename Value>
+bool ConcurrentHopscotchTable<Key, Value>::place(BucketArray* array, Node* node) {
+    size_t home = node->hash % array->capacity;
+    size_t freeBucket = makeRoom(array, home);
+    if (freeBucket == HOPSCOTCH_NOT_FOUND) return false;
+    array->buckets[freeBucket].node.store(node, std::memory_order_relaxed);
+    array->buckets[home].hopInfo.fetch_or(1U << (freeBucket - home), std::memory_order_relaxed);
+    return true;
+}
+
+// Rebuild at double capacity while holding every stripe of the old array. The new
+// array is published before the locks are released, so waiting writers retry on it.
+// A candidate must also have room for the key being inserted (hash), or the table
+// would keep doubling for a key it can never take. Every stripe stays locked
+// meanwhile, so the attempts are capped.
+template <typename Key, typename Value>
+bool ConcurrentHopscotchTable<Key, Value>::resize(BucketArray* expected, size_t hash) {
+    size_t last = expected->capacity + ADD_RANGE - 1;
+    lockRange(expected, 0, last);
+    if (array_.load(std::memory_order_acquire) != expected) {  // Someone else resized first
+        unlockRange(expected, 0, last);
+        return true;
+    }
+    size_t newCapacity = expected->capacity * 2;
+    for (size_t attempt = 0; attempt < MAX_GROWTH_ATTEMPTS; ++attempt, newCapacity *= 2) {
+        std::unique_ptr<BucketArray> fresh(new BucketArray(newCapacity));
+        bool placed = true;
+        for (size_t i = 0; i <= last && placed; ++i) {
+            Node* node = expected->buckets[i].node.load(std::memory_order_relaxed);
+            if (node) placed = place(fresh.get(), node);
+        }
+        if (placed) placed = makeRoom(fresh.get(), hash % newCapacity) != HOPSCOTCH_NOT_FOUND;
+        if (placed) {
+            array_.store(fresh.release(), std::memory_order_release);
+            resizes_.fetch_add(1, std::memory_order_relaxed);
+            unlockRange(expected, 0, last);
+            Epoch::retire(expected);  // Nodes now belong to the new array
+            return true;
+        }
+    }
+    unlockRange(expected, 0, last);
+    return false;
+}
+
+// Explicit instantiations
+template class ConcurrentHopscotchTable<std::string, int>;
+template class ConcurrentHopscotchTable<std::string, std::string>;
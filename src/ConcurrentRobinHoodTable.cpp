@@ -0,0 +1,287 @@
+#include "ConcurrentRobinHoodTable.hpp"
+#include "EpochReclamation.hpp"
+#include <algorithm>
+#include <string>
+#include <thread>
+
+template <typename Key, typename Value>
+ConcurrentRobinHoodTable<Key, Value>::SlotArray::SlotArray(size_t capacity)
+    : capacity(capacity), slots(new std::atomic<Node*>[capacity + MAX_PROBE]),
+      stripeCount((capacity + MAX_PROBE + LOCK_STRIPE - 1) / LOCK_STRIPE), stripes(new Stripe[stripeCount]) {
+    for (size_t i = 0; i < slotCount(); ++i) slots[i].store(nullptr, std::memory_order_relaxed);
+}
+
+template <typename Key, typename Value>
+ConcurrentRobinHoodTable<Key, Value>::LockedRange::LockedRange(SlotArray* array, size_t slot)
+    : array(array), first(slot / LOCK_STRIPE), last(slot / LOCK_STRIPE) {
+    array->stripes[first].lock.lock();
+}
+
+template <typename Key, typename Value>
+ConcurrentRobinHoodTable<Key, Value>::LockedRange::~LockedRange() {
+    for (size_t s = last + 1; s-- > first;) array->stripes[s].lock.unlock();
+}
+
+template <typename Key, typename Value>
+void ConcurrentRobinHoodTable<Key, Value>::LockedRange::extendTo(size_t slot) {
+    while (last < slot / LOCK_STRIPE) array->stripes[++last].lock.lock();
+}
+
+template <typename Key, typename Value>
+void ConcurrentRobinHoodTable<Key, Value>::LockedRange::beginWrite() {
+    for (size_t s = first; s <= last; ++s) {
+        std::atomic<uint64_t>& version = array->stripes[s].version;
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);  // Odd versions are visible before any moved slot
+}
+
+template <typename Key, typename Value>
+void ConcurrentRobinHoodTable<Key, Value>::LockedRange::endWrite() {
+    for (size_t s = first; s <= last; ++s) {
+        std::atomic<uint64_t>& version = array->stripes[s].version;
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+}
+
+template <typename Key, typename Value>
+ConcurrentRobinHoodTable<Key, Value>::ConcurrentRobinHoodTable(size_t initialCapacity)
+    : array_(new SlotArray(std::max<size_t>(initialCapacity, 1))), size_(0), searchRetries_(0),
+      lockedSearches_(0), resizes_(0), failedInserts_(0) {}
+
+// Caller guarantees no concurrent operations
+template <typename Key, typename Value>
+ConcurrentRobinHoodTable<Key, Value>::~ConcurrentRobinHoodTable() {
+    SlotArray* array = array_.load();
+    for (size_t i = 0; i < array->slotCount(); ++i) delete array->slots[i].load();
+    delete array;
+}
+
+template <typename Key, typename Value>
+bool ConcurrentRobinHoodTable<Key, Value>::insert(const Key& key, const Value& value) {
+    size_t hash = HashUtils::hash(key);
+    size_t growths = 0;
+    for (;;) {
+        Epoch::Guard guard;
+        SlotArray* array = array_.load(std::memory_order_acquire);
+        size_t home = array->home(hash);
+        size_t emptySlot = home;
+        size_t sameHash = 0;  // Probed entries with this full hash: they share a home at every capacity
+        {
+            LockedRange range(array, home);
+            if (array_.load(std::memory_order_acquire) != array) continue;  // Resized while we waited
+
+            // Find the end of the cluster, checking for the key on the way
+            bool fits = size() < MAX_LOAD_FACTOR * array->capacity;
+            for (; fits; ++emptySlot) {
+                if (emptySlot - home > MAX_PROBE) {
+                    fits = false;
+                    break;
+                }
+                range.extendTo(emptySlot);
+                Node* node = array->slots[emptySlot].load(std::memory_order_relaxed);
+                if (!node) break;
+                if (node->hash == hash && node->key == key) return false;
+                if (node->hash == hash) sameHash++;
+            }
+            if (fits) {
+                // Robin Hood: the carried entry takes the slot of any entry closer to its home
+                range.beginWrite();
+                Node* carry = new Node{hash, key, value};
+                for (size_t slot = home; carry; ++slot) {
+                    Node* node = array->slots[slot].load(std::memory_order_relaxed);
+                    if (!node || slot - array->home(node->hash) < slot - array->home(carry->hash)) {
+                        array->slots[slot].store(carry, std::memory_order_release);
+                        carry = node;
+                    }
+                }
+                range.endWrite();
+                size_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        // A probe run entirely of its own hash cannot be shortened by growing
+        if (sameHash > MAX_PROBE || ++growths > MAX_GROWTH_ATTEMPTS || !resize(array, hash)) {
+            failedInserts_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+}
+
+template <typename Key, typename Value>
+bool ConcurrentRobinHoodTable<Key, Value>::remove(const Key& key) {
+    size_t hash = HashUtils::hash(key);
+    for (;;) {
+        Epoch::Guard guard;
+        SlotArray* array = array_.load(std::memory_order_acquire);
+        size_t home = array->home(hash);
+        LockedRange range(array, home);
+        if (array_.load(std::memory_order_acquire) != array) continue;
+
+        size_t found = home;
+        Node* target = nullptr;
+        for (;; ++found) {
+            if (found - home > MAX_PROBE) return false;  // No entry sits further than MAX_PROBE from home
+            range.extendTo(found);
+            Node* node = array->slots[found].load(std::memory_order_relaxed);
+            if (!node || found - array->home(node->hash) < found - home) return false;
+            if (node->hash == hash && node->key == key) {
+                target = node;
+                break;
+            }
+        }
+        // The backward shift runs until an empty slot or an entry already at its home
+        size_t end = found + 1;
+        for (; end < array->slotCount(); ++end) {
+            range.extendTo(end);
+            Node* node = array->slots[end].load(std::memory_order_relaxed);
+            if (!node || array->home(node->hash) == end) break;
+        }
+        range.beginWrite();
+        for (size_t slot = found; slot + 1 < end; ++slot) {
+            array->slots[slot].store(array->slots[slot + 1].load(std::memory_order_relaxed), std::memory_order_release);
+        }
+        array->slots[end - 1].store(nullptr, std::memory_order_release);
+        range.endWrite();
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        Epoch::retire(target);
+        return true;
+    }
+}
+
+template <typename Key, typename Value>
+std::optional<Value> ConcurrentRobinHoodTable<Key, Value>::search(const Key& key) const {
+    size_t hash = HashUtils::hash(key);
+    Epoch::Guard guard;
+    SlotArray* array = array_.load(std::memory_order_acquire);
+    for (size_t attempt = 0; attempt < MAX_READ_RETRIES; ++attempt) {
+        bool consistent;
+        std::optional<Value> result = probe(array, hash, key, consistent);
+        if (consistent) return result;
+        searchRetries_.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::yield();
+    }
+    // Writers keep moving this cluster: read it under its stripe locks
+    lockedSearches_.fetch_add(1, std::memory_order_relaxed);
+    size_t home = array->home(hash);
+    LockedRange range(array, home);
+    for (size_t slot = home; slot - home <= MAX_PROBE; ++slot) {
+        range.extendTo(slot);
+        Node* node = array->slots[slot].load(std::memory_order_relaxed);
+        if (!node || slot - array->home(node->hash) < slot - home) return std::nullopt;
+        if (node->hash == hash && node->key == key) return node->value;
+    }
+    return std::nullopt;
+}
+
+// One optimistic lookup. consistent is false if a stripe it read was being written.
+template <typename Key, typename Value>
+std::optional<Value> ConcurrentRobinHoodTable<Key, Value>::probe(const SlotArray* array, size_t hash, const Key& key,
+                                                                 bool& consistent) {
+    size_t home = array->home(hash);
+    size_t firstStripe = home / LOCK_STRIPE;
+    uint64_t versions[MAX_PROBE / LOCK_STRIPE + 2];
+    size_t stripesRead = 0;
+    const Node* found = nullptr;
+    for (size_t slot = home; slot - home <= MAX_PROBE; ++slot) {
+        if (slot / LOCK_STRIPE >= firstStripe + stripesRead) {
+            uint64_t version = array->stripes[slot / LOCK_STRIPE].version.load(std::memory_order_acquire);
+            if (version & 1) {
+                consistent = false;
+                return std::nullopt;
+            }
+            versions[stripesRead++] = version;
+        }
+        const Node* node = array->slots[slot].load(std::memory_order_acquire);
+        if (!node || slot - array->home(node->hash) < slot - home) break;
+        if (node->hash == hash && node->key == key) {
+            found = node;
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    for (size_t i = 0; i < stripesRead; ++i) {
+        if (array->stripes[firstStripe + i].version.load(std::memory_order_relaxed) != versions[i]) {
+            consistent = false;
+            return std::nullopt;
+        }
+    }
+    consistent = true;
+    return found ? std::optional<Value>(found->value) : std::nullopt;
+}
+
+template <typename Key, typename Value>
+size_t ConcurrentRobinHoodTable<Key, Value>::capacity() const {
+    Epoch::Guard guard;
+    return array_.load(std::memory_order_acquire)->capacity;
+}
+
+template <typename Key, typename Value>
+double ConcurrentRobinHoodTable<Key, Value>::loadFactor() const {
+    return static_cast<double>(size()) / capacity();
+}
+
+template <typename Key, typename Value>
+typename ConcurrentRobinHoodTable<Key, Value>::Stats ConcurrentRobinHoodTable<Key, Value>::stats() const {
+    Stats s;
+    s.size = size();
+    s.capacity = capacity();
+    s.searchRetries = searchRetries_.load(std::memory_order_relaxed);
+    s.lockedSearches = lockedSearches_.load(std::memory_order_relaxed);
+    s.resizes = resizes_.load(std::memory_order_relaxed);
+    s.failedInserts = failedInserts_.load(std::memory_order_relaxed);
+    return s;
+}
+
+template <typename Key, typename Value>
+bool ConcurrentRobinHoodTable<Key, Value>::place(SlotArray* array, Node* node) {
+    size_t home = array->home(node->hash);
+    Node* carry = node;
+    for (size_t slot = home; carry; ++slot) {
+        if (slot >= array->slotCount() || slot - array->home(carry->hash) > MAX_PROBE) return false;
+        Node* current = array->slots[slot].load(std::memory_order_relaxed);
+        if (!current || slot - array->home(current->hash) < slot - array->home(carry->hash)) {
+            array->slots[slot].store(carry, std::memory_order_relaxed);
+            carry = current;
+        }
+    }
+    return true;
+}
+
+// Rebuild at double capacity while holding every stripe of the old array; the new
+// array is published before the locks are released, so waiting writers retry on it.
+// A candidate must also leave the key being inserted (hash) an empty slot within
+// MAX_PROBE, or the table would keep doubling for a key it can never take. Every
+// stripe stays locked meanwhile, so the attempts are capped.
+template <typename Key, typename Value>
+bool ConcurrentRobinHoodTable<Key, Value>::resize(SlotArray* expected, size_t hash) {
+    LockedRange range(expected, 0);
+    range.extendTo(expected->slotCount() - 1);
+    if (array_.load(std::memory_order_acquire) != expected) return true;  // Someone else resized first
+    size_t newCapacity = expected->capacity * 2;
+    for (size_t attempt = 0; attempt < MAX_GROWTH_ATTEMPTS; ++attempt, newCapacity *= 2) {
+        std::unique_ptr<SlotArray> fresh(new SlotArray(newCapacity));
+        bool placed = true;
+        for (size_t i = 0; i < expected->slotCount() && placed; ++i) {
+            Node* node = expected->slots[i].load(std::memory_order_relaxed);
+            if (node) placed = place(fresh.get(), node);
+        }
+        if (placed) {
+            size_t home = fresh->home(hash);
+            size_t slot = home;
+            while (slot - home <= MAX_PROBE && fresh->slots[slot].load(std::memory_order_relaxed)) ++slot;
+            placed = slot - home <= MAX_PROBE;
+        }
+        if (placed) {
+            array_.store(fresh.release(), std::memory_order_release);
+            resizes_.fetch_add(1, std::memory_order_relaxed);
+            Epoch::retire(expected);  // Freed after the locks are released and readers have moved on
+            return true;
+        }
+    }
+    return false;
+}
+
+// Explicit instantiations
+template class ConcurrentRobinHoodTable<std::string, int>;
+template class ConcurrentRobinHoodTable<std::string, std::string>;
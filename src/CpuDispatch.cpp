@@ -0,0 +1,148 @@
+#include "CpuDispatch.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HYBRID_HASH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace CpuDispatch {
+namespace {
+    // Generic variants: portable and what every other variant must agree with
+    size_t findByteGeneric(const char* data, size_t length, char c) {
+        const void* hit = std::memchr(data, c, length);
+        return hit ? static_cast<const char*>(hit) - data : length;
+    }
+
+#ifdef HYBRID_HASH_X86
+    __attribute__((target("avx2,bmi")))
+    size_t findByteAvx2(const char* data, size_t length, char c) {
+        const __m256i needle = _mm256_set1_epi8(c);
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+            if (mask) return i + _tzcnt_u32(mask);
+        }
+        return i + findByteGeneric(data + i, length - i, c);
+    }
+
+    __attribute__((target("avx512f,avx512bw,bmi,bmi2")))
+    size_t findByteAvx512(const char* data, size_t length, char c) {
+        const __m512i needle = _mm512_set1_epi8(c);
+        size_t i = 0;
+        for (; i + 64 <= length; i += 64) {
+            __m512i block = _mm512_loadu_si512(data + i);
+            uint64_t mask = _mm512_cmpeq_epi8_mask(block, needle);
+            if (mask) return i + _tzcnt_u64(mask);
+        }
+        // Masked load handles the tail without reading past the end
+        if (i < length) {
+            __mmask64 valid = _bzhi_u64(~uint64_t(0), static_cast<unsigned>(length - i));
+            __m512i block = _mm512_maskz_loadu_epi8(valid, data + i);
+            uint64_t mask = _mm512_mask_cmpeq_epi8_mask(valid, block, needle);
+            if (mask) return i + _tzcnt_u64(mask);
+        }
+        return length;
+    }
+#endif
+
+    CpuFeatures detectFeatures() {
+        CpuFeatures f;
+#ifdef HYBRID_HASH_X86
+        __builtin_cpu_init();
+        f.sse42 = __builtin_cpu_supports("sse4.2");
+        f.popcnt = __builtin_cpu_supports("popcnt");
+        f.avx2 = __builtin_cpu_supports("avx2");
+        f.bmi1 = __builtin_cpu_supports("bmi");
+        f.bmi2 = __builtin_cpu_supports("bmi2");
+        f.avx512bw = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+        return f;
+    }
+
+    IsaLevel detectLevel(const CpuFeatures& f) {
+        IsaLevel level = IsaLevel::Generic;
+        if (f.sse42 && f.popcnt) level = IsaLevel::SSE42;
+        if (level == IsaLevel::SSE42 && f.avx2 && f.bmi1 && f.bmi2) level = IsaLevel::AVX2;
+        if (level == IsaLevel::AVX2 && f.avx512bw) level = IsaLevel::AVX512;
+
+        if (const char* override = std::getenv("HYBRID_HASH_ISA")) {
+            IsaLevel cap = level;
+            if (std::strcmp(override, "generic") == 0) cap = IsaLevel::Generic;
+            else if (std::strcmp(override, "sse4.2") == 0) cap = IsaLevel::SSE42;
+            else if (std::strcmp(override, "avx2") == 0) cap = IsaLevel::AVX2;
+            else if (std::strcmp(override, "avx512") == 0) cap = IsaLevel::AVX512;
+            else std::cerr << "Warning: Ignoring unknown HYBRID_HASH_ISA=" << override << "\n";
+            // An override can only lower the tier; asking for more than the CPU has is ignored
+            if (cap < level) level = cap;
+        }
+        return level;
+    }
+
+    Kernels bindKernels(IsaLevel level) {
+        Kernels k{findByteGeneric, "generic"};
+#ifdef HYBRID_HASH_X86
+        if (level >= IsaLevel::AVX512) {
+            k.findByte = findByteAvx512;
+            k.findByteVariant = "avx512bw";
+        } else if (level >= IsaLevel::AVX2) {
+            k.findByte = findByteAvx2;
+            k.findByteVariant = "avx2";
+        }
+#else
+        (void)level;
+#endif
+        return k;
+    }
+
+    const char* levelName(IsaLevel level) {
+        switch (level) {
+            case IsaLevel::Generic: return "generic";
+            case IsaLevel::SSE42: return "sse4.2";
+            case IsaLevel::AVX2: return "avx2";
+            case IsaLevel::AVX512: return "avx512";
+        }
+        return "unknown";
+    }
+}
+
+const CpuFeatures& features() {
+    static const CpuFeatures detected = detectFeatures();
+    return detected;
+}
+
+IsaLevel selectedLevel() {
+    static const IsaLevel level = detectLevel(features());
+    return level;
+}
+
+const Kernels& kernels() {
+    static const Kernels bound = bindKernels(selectedLevel());
+    return bound;
+}
+
+std::string report() {
+    const CpuFeatures& f = features();
+    std::string out = "CPU features:";
+    if (f.sse42) out += " sse4.2";
+    if (f.popcnt) out += " popcnt";
+    if (f.avx2) out += " avx2";
+    if (f.bmi1) out += " bmi";
+    if (f.bmi2) out += " bmi2";
+    if (f.avx512bw) out += " avx512bw";
+    out += "; tier: ";
+    out += levelName(selectedLevel());
+    out += "; findByte=";
+    out += kernels().findByteVariant;
+    return out;
+}
+
+// Bind at startup rather than on the first hot-path call
+namespace {
+    const bool boundAtStartup = (kernels(), true);
+}
+}
@@ -0,0 +1,291 @@
+#include "DataLoader.hpp"
+#include "AsyncFileReader.hpp"
+#include "CardinalityEstimator.hpp"
+#include "CpuDispatch.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <glob.h>
+#include <sys/stat.h>
+
+namespace {
+    const double PRESIZE_LOAD_FACTOR = 0.75;
+    const double PRESIZE_ERROR_MARGIN = 3.0;  // Standard errors of headroom over the estimate
+    const size_t LOAD_BATCH_BYTES = size_t(1) << 20;  // Parsed rows handed over at a time
+
+    // Read a file with reads kept in flight ahead of the parser and call fn(line) for
+    // every line. Line and field splitting use the dispatched findByte kernel instead
+    // of per-character streams.
+    template <typename Fn>
+    bool forEachLine(const std::string& filename, Fn&& fn, AsyncFileReader& reader) {
+        std::string carry;  // Unfinished line from the end of the previous block
+        bool ok = reader.readFile(filename, [&](const char* data, size_t length) {
+            size_t pos = 0;
+            if (!carry.empty()) {
+                size_t newline = CpuDispatch::findByte(data, length, '\n');
+                carry.append(data, newline);
+                if (newline == length) return;  // Line longer than the block
+                fn(std::string_view(carry));
+                carry.clear();
+                pos = newline + 1;
+            }
+            while (pos < length) {
+                size_t newline = pos + CpuDispatch::findByte(data + pos, length - pos, '\n');
+                if (newline == length) break;
+                fn(std::string_view(data + pos, newline - pos));
+                pos = newline + 1;
+            }
+            carry.assign(data + pos, length - pos);
+        });
+        if (ok && !carry.empty()) fn(std::string_view(carry));  // Last line without newline
+        return ok;
+    }
+
+    template <typename Fn>
+    bool forEachLine(const std::string& filename, Fn&& fn) {
+        AsyncFileReader reader;
+        return forEachLine(filename, std::forward<Fn>(fn), reader);
+    }
+
+    // Split a "key,value" line; false without a comma or with an empty value
+    bool splitRow(std::string_view line, std::string_view& key, std::string_view& value) {
+        size_t comma = CpuDispatch::findByte(line.data(), line.size(), ',');
+        if (comma == line.size() || comma + 1 == line.size()) return false;
+        key = line.substr(0, comma);
+        value = line.substr(comma + 1);
+        return true;
+    }
+
+    struct RowBatch {
+        std::vector<std::pair<std::string, std::string>> rows;
+        size_t bytes = 0;
+    };
+
+    // Parsed batches of one file, waiting to be applied
+    struct FileQueue {
+        std::deque<RowBatch> batches;
+        bool started = false;  // Claimed by a parser thread or by the applying thread
+        bool finished = false;
+        bool ok = true;
+        size_t bytes = 0;      // File bytes read
+    };
+
+    // State shared by the parser threads and the thread applying rows, under mutex
+    struct MultiLoad {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<FileQueue> queues;
+        size_t next = 0;      // First file a parser may claim
+        size_t applying = 0;  // File whose rows are being applied
+        size_t buffered = 0;  // Bytes of parsed rows waiting
+        size_t maxBuffered = 0;
+    };
+
+    // Parser thread: claim files in list order and parse them into batches. A batch
+    // waits while the buffer is full, unless its file is the one being applied (waiting
+    // then would stall the applier, which frees the buffer). Parsers block, so they get
+    // threads of their own rather than pool tasks: a pool task can end up running
+    // inside another thread's wait, under whatever locks that thread holds.
+    void parseFiles(MultiLoad& load, const std::vector<std::string>& files) {
+        AsyncFileReader reader;
+        for (;;) {
+            size_t file;
+            {
+                std::lock_guard<std::mutex> lock(load.mutex);
+                while (load.next < files.size() && load.queues[load.next].started) load.next++;
+                if (load.next == files.size()) return;
+                file = load.next++;
+                load.queues[file].started = true;
+            }
+            RowBatch batch;
+            auto handOver = [&] {
+                std::unique_lock<std::mutex> lock(load.mutex);
+                load.changed.wait(lock, [&] { return load.buffered < load.maxBuffered || load.applying == file; });
+                load.buffered += batch.bytes;
+                load.queues[file].batches.push_back(std::move(batch));
+                batch = RowBatch();
+                load.changed.notify_all();
+            };
+            size_t before = reader.stats().bytes;
+            bool ok = forEachLine(files[file], [&](std::string_view line) {
+                std::string_view key, value;
+                if (!splitRow(line, key, value)) return;
+                batch.rows.emplace_back(std::string(key), std::string(value));
+                batch.bytes += key.size() + value.size() + 2 * sizeof(std::string);
+                if (batch.bytes >= LOAD_BATCH_BYTES) handOver();
+            }, reader);
+            if (!batch.rows.empty()) handOver();
+            std::lock_guard<std::mutex> lock(load.mutex);
+            load.queues[file].finished = true;
+            load.queues[file].ok = ok;
+            load.queues[file].bytes = reader.stats().bytes - before;
+            load.changed.notify_all();
+        }
+    }
+}
+
+size_t presizeForFile(HybridHashTable<std::string, std::string>& table, const std::string& filename) {
+    return presizeForFiles(table, {filename});
+}
+
+size_t presizeForFiles(HybridHashTable<std::string, std::string>& table, const std::vector<std::string>& files) {
+    size_t estimate;
+    double error;
+    bool estimated = files.size() == 1 ? estimateDistinctKeys(files.front(), estimate, &error)
+                                       : estimateDistinctKeys(files, estimate, &error);
+    if (!estimated) return 0;
+    double targetLoad = std::min(table.config().maxLoadFactor, PRESIZE_LOAD_FACTOR);
+    size_t capacity = static_cast<size_t>(estimate * (1.0 + PRESIZE_ERROR_MARGIN * error) / targetLoad) + 1;
+    if (capacity > table.capacity()) table.resize(capacity);
+    return estimate;
+}
+
+void loadFromFile(HybridHashTable<std::string, std::string>& table, const std::string& filename, std::vector<std::string>& keys,
+                  bool presize) {
+    if (presize && table.size() == 0) {
+        auto estimateStart = std::chrono::high_resolution_clock::now();
+        size_t estimate = presizeForFile(table, filename);
+        double estimateTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - estimateStart).count();
+        if (estimate > 0) {
+            std::cout << "Estimated " << estimate << " distinct keys in " << estimateTime << "s, capacity "
+                      << table.capacity() << "\n";
+        }
+    }
+    size_t inserted = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    AsyncFileReader reader;
+    bool opened = forEachLine(filename, [&](std::string_view line) {
+        std::string_view keyView, value;
+        if (!splitRow(line, keyView, value)) return;
+        std::string key(keyView);
+        if (table.insert(key, std::string(value))) {
+            inserted++;
+            keys.push_back(std::move(key));  // Store keys for later operations
+        }
+    }, reader);
+    if (!opened) return;
+    const AsyncFileReader::Stats& io = reader.stats();
+    std::cout << "Read " << io.bytes / (1 << 20) << " MiB with " << reader.backendName() << " at " << io.bandwidthMBps()
+              << " MiB/s (queue depth mean " << io.meanQueueDepth << ", max " << io.maxQueueDepth << ")\n";
+    auto end = std::chrono::high_resolution_clock::now();
+    double time = std::chrono::duration<double>(end - start).count();
+    std::cout << inserted << " items inserted in " << time << "s (" << inserted / time << " inserts/sec)\n";
+}
+
+LoadReport loadFromFiles(HybridHashTable<std::string, std::string>& table, const std::vector<std::string>& files,
+                         std::vector<std::string>& keys, DuplicatePolicy policy, size_t maxBufferedBytes, bool presize) {
+    if (presize && table.size() == 0) {
+        auto estimateStart = std::chrono::high_resolution_clock::now();
+        size_t estimate = presizeForFiles(table, files);
+        double estimateTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - estimateStart).count();
+        if (estimate > 0) {
+            std::cout << "Estimated " << estimate << " distinct keys in " << estimateTime << "s, capacity "
+                      << table.capacity() << "\n";
+        }
+    }
+    LoadReport report;
+    report.files = files.size();
+    auto start = std::chrono::high_resolution_clock::now();
+    auto apply = [&](const std::string& key, const std::string& value) {
+        report.rows++;
+        bool inserted = policy == DuplicatePolicy::LastWins ? table.insertOrAssign(key, value) : table.insert(key, value);
+        if (inserted) {
+            report.inserted++;
+            keys.push_back(key);
+        } else if (policy == DuplicatePolicy::LastWins) {
+            report.replaced++;
+        } else {
+            report.ignored++;
+        }
+    };
+
+    MultiLoad load;
+    load.queues.resize(files.size());
+    load.maxBuffered = maxBufferedBytes;
+    std::vector<std::thread> parsers(std::min<size_t>(files.size(), std::max(std::thread::hardware_concurrency(), 1u)));
+    for (auto& parser : parsers) parser = std::thread([&load, &files] { parseFiles(load, files); });
+
+    AsyncFileReader reader;  // For files no parser has reached yet
+    for (size_t file = 0; file < files.size(); ++file) {
+        FileQueue& queue = load.queues[file];
+        bool claimed;
+        {
+            std::lock_guard<std::mutex> lock(load.mutex);
+            load.applying = file;
+            claimed = !queue.started;
+            queue.started = true;
+        }
+        load.changed.notify_all();  // Its parser may be waiting for buffer space
+
+        if (claimed) {
+            // Parse it here and apply rows as they come: same order, no buffering
+            size_t before = reader.stats().bytes;
+            bool ok = forEachLine(files[file], [&](std::string_view line) {
+                std::string_view key, value;
+                if (splitRow(line, key, value)) apply(std::string(key), std::string(value));
+            }, reader);
+            report.bytes += reader.stats().bytes - before;
+            if (!ok) report.failedFiles++;
+            continue;
+        }
+        for (;;) {
+            RowBatch batch;
+            {
+                std::unique_lock<std::mutex> lock(load.mutex);
+                load.changed.wait(lock, [&] { return !queue.batches.empty() || queue.finished; });
+                if (queue.batches.empty()) {
+                    report.bytes += queue.bytes;
+                    if (!queue.ok) report.failedFiles++;
+                    break;
+                }
+                batch = std::move(queue.batches.front());
+                queue.batches.pop_front();
+                load.buffered -= batch.bytes;
+            }
+            load.changed.notify_all();
+            for (const auto& row : batch.rows) apply(row.first, row.second);
+        }
+    }
+    for (auto& parser : parsers) parser.join();  // They reference load
+
+    report.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "Loaded " << report.files - report.failedFiles << "/" << report.files << " files: " << report.rows
+              << " rows, " << report.inserted << " new keys, "
+              << (policy == DuplicatePolicy::LastWins ? report.replaced : report.ignored)
+              << (policy == DuplicatePolicy::LastWins ? " replaced" : " duplicates ignored") << " in " << report.seconds
+              << "s (" << report.rowsPerSecond() << " rows/sec, " << report.bandwidthMBps() << " MiB/s)\n";
+    return report;
+}
+
+bool expandFilePattern(const std::string& pattern, std::vector<std::string>& files) {
+    struct stat info;
+    bool directory = stat(pattern.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+    glob_t matches;
+    int result = glob((directory ? pattern + "/*" : pattern).c_str(), 0, nullptr, &matches);  // Sorted
+    size_t found = 0;
+    if (result == 0) {
+        for (size_t i = 0; i < matches.gl_pathc; ++i) {
+            if (stat(matches.gl_pathv[i], &info) != 0 || !S_ISREG(info.st_mode)) continue;
+            files.emplace_back(matches.gl_pathv[i]);
+            found++;
+        }
+    }
+    globfree(&matches);
+    if (found == 0) {
+        std::cerr << "Error: No files match " << pattern << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool readKeysFromFile(const std::string& filename, std::vector<std::string>& keys) {
+    return forEachLine(filename, [&keys](std::string_view line) {
+        if (line.empty()) return;
+        keys.emplace_back(line.substr(0, CpuDispatch::findByte(line.data(), line.size(), ',')));
+    });
+}
@@ -0,0 +1,122 @@
+#include "EpochReclamation.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace {
+    const size_t RECLAIM_INTERVAL = 64;  // Retires between reclamation attempts
+
+    struct Retired {
+        void* object;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    // One per thread, reused after the thread exits; never freed
+    struct ThreadRecord {
+        std::atomic<uint64_t> epoch{0};  // Epoch the thread entered its guard in, 0 outside guards
+        std::atomic<bool> inUse{false};
+        ThreadRecord* next = nullptr;
+        size_t depth = 0;
+        std::vector<Retired> retired;
+    };
+
+    std::atomic<uint64_t> globalEpoch{1};
+    std::atomic<ThreadRecord*> records{nullptr};
+    std::atomic<size_t> pendingCount{0};
+    std::mutex orphansMutex;
+    std::vector<Retired> orphans;  // Left behind by exited threads
+
+    ThreadRecord* acquireRecord() {
+        for (ThreadRecord* r = records.load(std::memory_order_acquire); r; r = r->next) {
+            bool expected = false;
+            if (!r->inUse.load(std::memory_order_relaxed) && r->inUse.compare_exchange_strong(expected, true)) return r;
+        }
+        ThreadRecord* r = new ThreadRecord;
+        r->inUse.store(true, std::memory_order_relaxed);
+        r->next = records.load(std::memory_order_relaxed);
+        while (!records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+        return r;
+    }
+
+    struct LocalRecord {
+        ThreadRecord* record = acquireRecord();
+        ~LocalRecord() {
+            if (!record->retired.empty()) {
+                std::lock_guard<std::mutex> lock(orphansMutex);
+                orphans.insert(orphans.end(), record->retired.begin(), record->retired.end());
+                record->retired.clear();
+            }
+            record->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    ThreadRecord& localRecord() {
+        thread_local LocalRecord local;
+        return *local.record;
+    }
+
+    // The epoch can move on once every active thread has observed the current one
+    void tryAdvance() {
+        uint64_t epoch = globalEpoch.load();
+        for (ThreadRecord* r = records.load(std::memory_order_acquire); r; r = r->next) {
+            uint64_t seen = r->epoch.load();
+            if (seen != 0 && seen != epoch) return;
+        }
+        globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    // Objects retired in epoch e can only be reached by guards entered in e or earlier,
+    // and all of those have exited once the global epoch reaches e + 2
+    void freeSafe(std::vector<Retired>& list) {
+        uint64_t epoch = globalEpoch.load();
+        size_t kept = 0;
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (list[i].epoch + 2 <= epoch) {
+                list[i].deleter(list[i].object);
+                pendingCount.fetch_sub(1, std::memory_order_relaxed);
+            } else {
+                list[kept++] = list[i];
+            }
+        }
+        list.resize(kept);
+    }
+}
+
+namespace Epoch {
+    Guard::Guard() {
+        ThreadRecord& record = localRecord();
+        if (record.depth++ > 0) return;
+        // Publish the epoch, then make sure it did not move before the publication was visible
+        uint64_t epoch = globalEpoch.load();
+        for (;;) {
+            record.epoch.store(epoch);
+            uint64_t now = globalEpoch.load();
+            if (now == epoch) break;
+            epoch = now;
+        }
+    }
+
+    Guard::~Guard() {
+        ThreadRecord& record = localRecord();
+        if (--record.depth == 0) record.epoch.store(0, std::memory_order_release);
+    }
+
+    void retire(void* object, void (*deleter)(void*)) {
+        ThreadRecord& record = localRecord();
+        record.retired.push_back({object, deleter, globalEpoch.load()});
+        pendingCount.fetch_add(1, std::memory_order_relaxed);
+        if (record.retired.size() % RECLAIM_INTERVAL == 0) reclaim();
+    }
+
+    void reclaim() {
+        tryAdvance();
+        freeSafe(localRecord().retired);
+        std::unique_lock<std::mutex> lock(orphansMutex, std::try_to_lock);
+        if (lock.owns_lock() && !orphans.empty()) freeSafe(orphans);
+    }
+
+    size_t pending() {
+        return pendingCount.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,142 @@
+#include "ExtendibleHashTable.hpp"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+
+template <typename Key, typename Value>
+ExtendibleHashTable<Key, Value>::ExtendibleHashTable(size_t segmentCapacity, HashMode mode, const HashTableConfig& config)
+    : globalDepth_(0), segmentCapacity_(std::max<size_t>(segmentCapacity, 1)), mode_(mode), segmentConfig_(config),
+      splitLoadFactor_(config.maxLoadFactor), size_(0), splits_(0) {
+    segmentConfig_.maxLoadFactor = std::numeric_limits<double>::infinity();  // Segments split instead of growing
+    directory_.push_back(std::make_shared<Segment>(Segment{makeTable(), 0}));
+}
+
+template <typename Key, typename Value>
+bool ExtendibleHashTable<Key, Value>::insert(const Key& key, const Value& value) {
+    uint64_t hash = directoryHash(key);
+    bool inserted;
+    bool needsSplit;
+    {
+        std::shared_lock<TableMutex> lock(mutex_);
+        const Segment& segment = *directory_[directoryIndex(hash)];
+        inserted = segment.table->insert(key, value);
+        needsSplit = inserted && overloaded(segment);
+    }
+    if (inserted) size_.fetch_add(1, std::memory_order_relaxed);
+    if (needsSplit) {
+        std::unique_lock<TableMutex> lock(mutex_);
+        split(hash);
+    }
+    return inserted;
+}
+
+template <typename Key, typename Value>
+bool ExtendibleHashTable<Key, Value>::remove(const Key& key) {
+    uint64_t hash = directoryHash(key);
+    std::shared_lock<TableMutex> lock(mutex_);
+    bool removed = directory_[directoryIndex(hash)]->table->remove(key);
+    if (removed) size_.fetch_sub(1, std::memory_order_relaxed);
+    return removed;
+}
+
+template <typename Key, typename Value>
+std::optional<Value> ExtendibleHashTable<Key, Value>::search(const Key& key) const {
+    uint64_t hash = directoryHash(key);
+    std::shared_lock<TableMutex> lock(mutex_);
+    return directory_[directoryIndex(hash)]->table->search(key);
+}
+
+template <typename Key, typename Value>
+size_t ExtendibleHashTable<Key, Value>::capacity() const {
+    std::shared_lock<TableMutex> lock(mutex_);
+    size_t segments = 0;
+    for (size_t i = 0; i < directory_.size(); ++i) {
+        if (i == 0 || directory_[i] != directory_[i - 1]) segments++;  // A segment's entries are contiguous
+    }
+    return segments * segmentCapacity_;
+}
+
+template <typename Key, typename Value>
+double ExtendibleHashTable<Key, Value>::loadFactor() const {
+    return static_cast<double>(size()) / capacity();
+}
+
+template <typename Key, typename Value>
+typename ExtendibleHashTable<Key, Value>::Stats ExtendibleHashTable<Key, Value>::stats() const {
+    std::shared_lock<TableMutex> lock(mutex_);
+    Stats s{};
+    s.size = size();
+    s.globalDepth = globalDepth_;
+    s.directorySize = directory_.size();
+    s.splits = splits_;
+    for (size_t i = 0; i < directory_.size(); ++i) {
+        if (i > 0 && directory_[i] == directory_[i - 1]) continue;
+        s.segments++;
+        s.maxSegmentSize = std::max(s.maxSegmentSize, directory_[i]->table->size());
+    }
+    s.capacity = s.segments * segmentCapacity_;
+    return s;
+}
+
+template <typename Key, typename Value>
+uint64_t ExtendibleHashTable<Key, Value>::directoryHash(const Key& key) {
+    return HashUtils::mix(HashUtils::hash(key));
+}
+
+template <typename Key, typename Value>
+std::unique_ptr<typename ExtendibleHashTable<Key, Value>::Table> ExtendibleHashTable<Key, Value>::makeTable() const {
+    std::unique_ptr<Table> table(new Table(segmentCapacity_, segmentConfig_));
+    if (mode_ != HashMode::Hopscotch) table->setMode(mode_);
+    return table;
+}
+
+// Bit width of size / segmentCapacity, plus the slack, so the directory stays
+// proportional to the entries even when splits cannot separate them
+template <typename Key, typename Value>
+size_t ExtendibleHashTable<Key, Value>::maxDepth() const {
+    size_t bits = 0;
+    for (size_t segments = size() / segmentCapacity_; segments; segments >>= 1) bits++;
+    return std::min<size_t>(bits + SPLIT_DEPTH_SLACK, 64);
+}
+
+template <typename Key, typename Value>
+bool ExtendibleHashTable<Key, Value>::overloaded(const Segment& segment) const {
+    return segment.table->size() > splitLoadFactor_ * segmentCapacity_ && segment.localDepth < maxDepth();
+}
+
+// Split the segment holding hash until it is below the split load. Only that
+// segment's keys move; the directory doubles when the segment is already at the
+// global depth.
+template <typename Key, typename Value>
+void ExtendibleHashTable<Key, Value>::split(uint64_t hash) {
+    for (;;) {
+        std::shared_ptr<Segment> old = directory_[directoryIndex(hash)];
+        if (!overloaded(*old)) return;  // Another inserter split it first
+
+        if (old->localDepth == globalDepth_) {
+            std::vector<std::shared_ptr<Segment>> doubled(directory_.size() * 2);
+            for (size_t i = 0; i < directory_.size(); ++i) doubled[2 * i] = doubled[2 * i + 1] = directory_[i];
+            directory_.swap(doubled);
+            globalDepth_++;
+        }
+
+        size_t depth = old->localDepth + 1;
+        auto low = std::make_shared<Segment>(Segment{makeTable(), depth});
+        auto high = std::make_shared<Segment>(Segment{makeTable(), depth});
+        old->table->forEach([&](const Key& key, const Value& value) {
+            bool bit = (directoryHash(key) >> (64 - depth)) & 1;
+            (bit ? high : low)->table->insert(key, value);
+        });
+        for (size_t i = 0; i < directory_.size(); ++i) {
+            if (directory_[i] != old) continue;
+            bool bit = (i >> (globalDepth_ - depth)) & 1;
+            directory_[i] = bit ? high : low;
+        }
+        splits_++;
+    }
+}
+
+// Explicit instantiations
+template class ExtendibleHashTable<std::string, int>;
+template class ExtendibleHashTable<std::string, std::string>;
@@ -0,0 +1,147 @@
+#include "HashAnalyzer.hpp"
+#include "HashFunctions.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+    const size_t HISTOGRAM_BINS = 8;
+
+    // Keys still looking for a slot after one sweep of the ring that starts with `carry` pending
+    size_t sweepCarry(const std::vector<size_t>& counts, size_t carry) {
+        for (size_t c : counts) {
+            carry += c;
+            if (carry > 0) carry--;
+        }
+        return carry;
+    }
+
+    // Replay linear-probing placement in FIFO order. Robin Hood reorders keys inside a
+    // cluster but occupies the same slots, so total (and mean) displacement is identical.
+    void analyzeLinearProbing(const std::vector<size_t>& counts, HashAnalysis& result) {
+        size_t capacity = counts.size();
+        if (result.numKeys == 0 || result.numKeys >= capacity) return;
+
+        // Settle how many keys wrap past the end, then find a slot that ends a cluster
+        size_t carry = 0;
+        for (size_t next = sweepCarry(counts, 0); next != carry; next = sweepCarry(counts, carry)) carry = next;
+        size_t start = 0;
+        for (size_t i = 0; i < capacity; ++i) {
+            carry += counts[i];
+            if (carry == 0) {
+                start = (i + 1) % capacity;
+                break;
+            }
+            carry--;
+        }
+
+        std::vector<size_t> pending;  // Unwrapped home positions waiting for a slot
+        size_t head = 0, run = 0, totalDisplacement = 0, maxDisplacement = 0;
+        for (size_t step = 0; step < capacity; ++step) {
+            size_t pos = start + step;
+            for (size_t k = 0; k < counts[pos % capacity]; ++k) pending.push_back(pos);
+            if (head < pending.size()) {
+                size_t displacement = pos - pending[head++];
+                totalDisplacement += displacement;
+                maxDisplacement = std::max(maxDisplacement, displacement);
+                result.longestCluster = std::max(result.longestCluster, ++run);
+            } else {
+                run = 0;
+            }
+        }
+        result.robinHoodMeanProbes = 1.0 + static_cast<double>(totalDisplacement) / result.numKeys;
+        result.robinHoodMaxDisplacement = maxDisplacement;
+    }
+}
+
+template <typename Key>
+HashAnalysis analyzeKeys(const std::vector<Key>& keys, size_t capacity, size_t hopRange) {
+    HashAnalysis result;
+    result.numKeys = keys.size();
+    result.capacity = capacity;
+    result.hopRange = hopRange;
+    if (capacity == 0) return result;
+
+    std::vector<size_t> counts(capacity, 0);
+    std::vector<size_t> counts1(capacity, 0);
+    double sum1 = 0, sum2 = 0, sum11 = 0, sum22 = 0, sum12 = 0;
+    size_t sameBucket = 0;
+    for (const auto& key : keys) {
+        size_t home = HashUtils::hash(key) % capacity;
+        size_t b1 = HashUtils::hash1(key) % capacity;
+        size_t b2 = HashUtils::hash2(key) % capacity;
+        counts[home]++;
+        counts1[b1]++;
+        if (b1 == b2) sameBucket++;
+        double x = static_cast<double>(b1), y = static_cast<double>(b2);
+        sum1 += x; sum2 += y; sum11 += x * x; sum22 += y * y; sum12 += x * y;
+    }
+
+    size_t n = keys.size();
+    double expected = static_cast<double>(n) / capacity;
+    result.occupancyHistogram.assign(HISTOGRAM_BINS, 0);
+    size_t sumSquares = 0;
+    for (size_t c : counts) {
+        result.occupancyHistogram[std::min(c, HISTOGRAM_BINS - 1)]++;
+        if (expected > 0) result.chiSquared += (c - expected) * (c - expected) / expected;
+        sumSquares += c * c;
+    }
+    double dof = static_cast<double>(capacity - 1);
+    result.chiSquaredZ = dof > 0 ? (result.chiSquared - dof) / std::sqrt(2.0 * dof) : 0.0;
+
+    analyzeLinearProbing(counts, result);
+
+    // Hopscotch neighborhoods here are aligned blocks of hopRange slots shared by their home buckets
+    size_t overflow = 0;
+    for (size_t start = 0; start < capacity; start += hopRange) {
+        size_t end = std::min(start + hopRange, capacity);
+        size_t inBlock = 0;
+        for (size_t i = start; i < end; ++i) inBlock += counts[i];
+        if (inBlock > end - start) overflow += inBlock - (end - start);
+    }
+    if (n > 0) {
+        result.hopscotchMeanProbes = static_cast<double>(sumSquares) / n;
+        result.hopscotchOverflowRate = static_cast<double>(overflow) / n;
+        size_t firstChoice = 0;
+        for (size_t c : counts1) firstChoice += (c > 0);
+        result.cuckooMeanProbes = 1.0 + static_cast<double>(n - firstChoice) / n;
+        result.cuckooSameBucketRate = static_cast<double>(sameBucket) / n;
+        double cov = sum12 / n - (sum1 / n) * (sum2 / n);
+        double var1 = sum11 / n - (sum1 / n) * (sum1 / n);
+        double var2 = sum22 / n - (sum2 / n) * (sum2 / n);
+        result.cuckooCorrelation = (var1 > 0 && var2 > 0) ? cov / std::sqrt(var1 * var2) : 0.0;
+    }
+    return result;
+}
+
+template <typename Key, typename Value>
+HashAnalysis analyzeTable(const HybridHashTable<Key, Value>& table) {
+    auto snapshot = table.snapshot();
+    std::vector<Key> keys;
+    keys.reserve(snapshot->size());
+    snapshot->forEach([&keys](const Key& key, const Value&) { keys.push_back(key); });
+    return analyzeKeys(keys, snapshot->capacity(), snapshot->config().hopRange);
+}
+
+void printHashAnalysis(const HashAnalysis& a, std::ostream& out) {
+    out << std::fixed << std::setprecision(3);
+    out << "Keys: " << a.numKeys << ", capacity: " << a.capacity
+        << ", load: " << (a.capacity ? static_cast<double>(a.numKeys) / a.capacity : 0.0) << "\n";
+    out << "Bucket occupancy histogram (keys per bucket -> buckets):\n";
+    for (size_t c = 0; c < a.occupancyHistogram.size(); ++c) {
+        out << "  " << c << (c + 1 == a.occupancyHistogram.size() ? "+" : "") << ": " << a.occupancyHistogram[c] << "\n";
+    }
+    out << "Chi-squared: " << a.chiSquared << " (z = " << a.chiSquaredZ << ")\n";
+    out << "Longest linear-probing cluster: " << a.longestCluster << "\n";
+    out << "Predicted probes - RobinHood: " << a.robinHoodMeanProbes << " (max displacement " << a.robinHoodMaxDisplacement
+        << "), Hopscotch: " << a.hopscotchMeanProbes << " (overflow " << a.hopscotchOverflowRate * 100 << "% at H="
+        << a.hopRange << "), Cuckoo: " << a.cuckooMeanProbes << "\n";
+    out << "Cuckoo hash1/hash2 correlation: " << a.cuckooCorrelation << ", same bucket: "
+        << a.cuckooSameBucketRate * 100 << "%\n";
+    out << std::defaultfloat;
+}
+
+// Explicit instantiations
+template HashAnalysis analyzeKeys<std::string>(const std::vector<std::string>&, size_t, size_t);
+template HashAnalysis analyzeTable<std::string, int>(const HybridHashTable<std::string, int>&);
+template HashAnalysis analyzeTable<std::string, std::string>(const HybridHashTable<std::string, std::string>&);
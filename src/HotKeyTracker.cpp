@@ -0,0 +1,71 @@
+#include "HotKeyTracker.hpp"
+#include <algorithm>
+#include <string>
+
+template <typename Key>
+HotKeyTracker<Key>::HotKeyTracker(size_t trackedKeys, size_t sampleRate)
+    : trackedKeys_(std::max<size_t>(trackedKeys, 1)), sampleRate_(std::max<size_t>(sampleRate, 1)), samples_(0) {
+    counters_.reserve(trackedKeys_);
+}
+
+template <typename Key>
+void HotKeyTracker<Key>::record(const Key& key) {
+    thread_local size_t tick = 0;
+    if (++tick % sampleRate_ != 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    samples_.fetch_add(1, std::memory_order_relaxed);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        counters_[it->second].count++;
+        return;
+    }
+    if (counters_.size() < trackedKeys_) {
+        index_.emplace(key, counters_.size());
+        counters_.push_back({key, 1, 0});
+        return;
+    }
+    // Replace the minimum counter; the newcomer inherits its count as error bound
+    size_t minPos = 0;
+    for (size_t i = 1; i < counters_.size(); ++i) {
+        if (counters_[i].count < counters_[minPos].count) minPos = i;
+    }
+    HotKey& victim = counters_[minPos];
+    index_.erase(victim.key);
+    victim.error = victim.count;
+    victim.count++;
+    victim.key = key;
+    index_.emplace(key, minPos);
+}
+
+template <typename Key>
+std::vector<typename HotKeyTracker<Key>::HotKey> HotKeyTracker<Key>::topK(size_t k) const {
+    std::vector<HotKey> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result = counters_;
+    }
+    std::sort(result.begin(), result.end(), [](const HotKey& a, const HotKey& b) { return a.count > b.count; });
+    if (result.size() > k) result.resize(k);
+    for (auto& hot : result) {
+        hot.count *= sampleRate_;
+        hot.error *= sampleRate_;
+    }
+    return result;
+}
+
+template <typename Key>
+size_t HotKeyTracker<Key>::samples() const {
+    return samples_.load(std::memory_order_relaxed);
+}
+
+template <typename Key>
+void HotKeyTracker<Key>::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.clear();
+    index_.clear();
+    samples_ = 0;
+}
+
+// Explicit instantiations
+template class HotKeyTracker<std::string>;
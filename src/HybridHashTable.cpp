@@ -1,19 +1,46 @@
 #include "HybridHashTable.hpp"
 #include <iostream>  // For debugging
+#include <algorithm>
+#include <chrono>
 
 template <typename Key, typename Value>
 HybridHashTable<Key, Value>::HybridHashTable(size_t initialSize, double maxLoadFactor)
-    : capacity_(initialSize), numElements_(0), maxLoadFactor_(maxLoadFactor), currentMode_(HashMode::Hopscotch),
-      totalInsertions_(0), totalCollisions_(0), totalProbes_(0) {
-    table_.resize(capacity_, std::nullopt);
-    table2_.resize(capacity_, std::nullopt);
-    hopInfo_.resize(capacity_, 0);
-    probeDistances_.resize(capacity_, 0);
+    : HybridHashTable(initialSize, [maxLoadFactor] {
+          HashTableConfig config;
+          config.maxLoadFactor = maxLoadFactor;
+          return config;
+      }()) {}
+
+template <typename Key, typename Value>
+HybridHashTable<Key, Value>::HybridHashTable(size_t initialSize, const HashTableConfig& config)
+    : capacity_(initialSize), numElements_(0), config_(config), currentMode_(HashMode::Hopscotch),
+      maxPinnedKeys_(0), nextPinRefresh_(0), recordSlowOps_(false), nextObserverId_(1), growthClaimed_(false),
+      stashAboveThreshold_(false),
+      memoryPolicy_(MemoryPolicy::Refuse), evicting_(false), refusedGrowths_(0), failedRehashes_(0), evictions_(0),
+      evictCursor_(0), versionClock_(0), totalInsertions_(0), totalCollisions_(0), totalProbes_(0), totalDisplacements_(0) {
+    config_.hopRange = std::min<size_t>(std::max<size_t>(config_.hopRange, 1), 32);  // Bitmap width
+    clearSlots();
     hash_ = HashUtils::hash<Key>;
     hash1_ = HashUtils::hash1<Key>;
     hash2_ = HashUtils::hash2<Key>;
 }
 
+template <typename Key, typename Value>
+HybridHashTable<Key, Value>::HybridHashTable(const HybridHashTable& other)
+    : table_(other.table_), capacity_(other.capacity_), numElements_(other.numElements_),
+      config_(other.config_), currentMode_(other.currentMode_),
+      table2_(other.table2_), hash1_(other.hash1_), hash2_(other.hash2_), hash_(other.hash_),
+      hopInfo_(other.hopInfo_), probeDistances_(other.probeDistances_), stash_(other.stash_),
+      frontTable_(other.frontTable_), maxPinnedKeys_(0), nextPinRefresh_(0), recordSlowOps_(false), nextObserverId_(1),
+      growthClaimed_(false), stashAboveThreshold_(other.stashAboveThreshold_),
+      memoryPolicy_(MemoryPolicy::Refuse), evicting_(false), refusedGrowths_(other.refusedGrowths_),
+      failedRehashes_(other.failedRehashes_), evictions_(other.evictions_), evictCursor_(0),
+      versionClock_(other.versionClock_.load()), totalInsertions_(other.totalInsertions_),
+      totalCollisions_(other.totalCollisions_), totalProbes_(other.totalProbes_),
+      totalDisplacements_(other.totalDisplacements_) {
+    // Arrays and stash are shared copy-on-write, so this is O(1)
+}
+
 template <typename Key, typename Value>
 HybridHashTable<Key, Value>::~HybridHashTable() {
     // Cleanup if needed
@@ -21,10 +48,73 @@ HybridHashTable<Key, Value>::~HybridHashTable() {
 
 template <typename Key, typename Value>
 bool HybridHashTable<Key, Value>::insert(const Key& key, const Value& value) {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-    if (searchInternal(key)) return false;
+    SlowOpScope slowOp(*this, SlowOpType::Insert);
+    bool inserted;
+    bool growNow;
+    std::vector<TableEvent> events;
+    {
+        std::unique_lock<TableMutex> lock(mutex_);
+        slowOp.begin();
+        recordAccess(key);
+        traceAccess(TraceOp::Insert, key);
+        if (evicting_ && numElements_ > config_.maxLoadFactor * capacity_ && !searchInternal(key)) evictOne();
+        inserted = insertInternal(key, value, nextVersion());
+        if (pinRefreshDue()) rebuildFrontTable();
+        growNow = claimGrowth();
+        slowOp.end(&key);
+        events.swap(pendingEvents_);
+    }
+    dispatchEvents(events);
+    if (growNow) {
+        slowOp.resized();
+        grow();
+    }
+    return inserted;
+}
+
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::insertOrAssign(const Key& key, const Value& value) {
+    SlowOpScope slowOp(*this, SlowOpType::Insert);
+    bool growNow;
+    std::vector<TableEvent> events;
+    {
+        std::unique_lock<TableMutex> lock(mutex_);
+        slowOp.begin();
+        recordAccess(key);
+        Entry* entry = exclusiveEntrySlot(key);
+        traceAccess(entry ? TraceOp::Update : TraceOp::Insert, key);
+        if (entry) {
+            entry->second = value;
+            entry->version = nextVersion();
+            syncPinned(key, value);
+            slowOp.end(&key);
+            return false;
+        }
+        if (evicting_ && numElements_ > config_.maxLoadFactor * capacity_) evictOne();
+        insertInternal(key, value, nextVersion());
+        if (pinRefreshDue()) rebuildFrontTable();
+        growNow = claimGrowth();
+        slowOp.end(&key);
+        events.swap(pendingEvents_);
+    }
+    dispatchEvents(events);
+    if (growNow) {
+        slowOp.resized();
+        grow();
+    }
+    return true;
+}
+
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::insertInternal(const Key& key, const Value& value, uint64_t version) {
+    // Not searchInternal: a rehash reinserts into emptied slots while the front table
+    // still holds the pinned copies
+    size_t existing;
+    if (findEntry(key, probeHint(key), existing) != EntryLocation::None) return false;
     totalInsertions_++;
     bool success = false;
+    // Robin Hood and cuckoo swap entries along the way; on failure this holds whichever one is left over
+    Entry item(key, value, version);
 
     if (currentMode_ == HashMode::Hopscotch) {
         size_t baseIndex = hash(key);
@@ -32,7 +122,7 @@ bool HybridHashTable<Key, Value>::insert(const Key& key, const Value& value) {
         size_t end = getNeighborhoodEnd(baseIndex);
         size_t emptyIndex = findEmptySlot(start, end);
         if (emptyIndex != capacity_) {
-            table_[emptyIndex] = {key, value};
+            table_[emptyIndex] = item;
             updateHopInfo(baseIndex, emptyIndex, true);
             numElements_++;
             success = true;
@@ -40,7 +130,7 @@ bool HybridHashTable<Key, Value>::insert(const Key& key, const Value& value) {
             // After displacement, find the new empty slot and insert directly
             size_t newEmptyIndex = findEmptySlot(start, end);
             if (newEmptyIndex != capacity_) {
-                table_[newEmptyIndex] = {key, value};
+                table_[newEmptyIndex] = item;
                 updateHopInfo(baseIndex, newEmptyIndex, true);
                 numElements_++;
                 success = true;
@@ -49,33 +139,35 @@ bool HybridHashTable<Key, Value>::insert(const Key& key, const Value& value) {
             totalCollisions_++;
         }
     } else if (currentMode_ == HashMode::RobinHood) {
-        std::pair<Key, Value> item = {key, value};
+        // Probe through const views: only the slots actually written claim their segments
+        const SegmentedArray<Slot>& table = table_;
+        const SegmentedArray<size_t>& distances = probeDistances_;
         size_t idealIndex = hash(key);
         size_t currentIndex = idealIndex;
         size_t currentDistance = 0;
-        for (size_t probe = 0; probe < MAX_PROBE_DISTANCE; ++probe) {
+        for (size_t probe = 0; probe < config_.maxProbeDistance; ++probe) {
             totalProbes_++;
             currentIndex = (idealIndex + probe) % capacity_;
-            if (!table_[currentIndex] || isTombstone(table_[currentIndex])) {
+            if (!table[currentIndex] || isTombstone(table[currentIndex])) {
                 table_[currentIndex] = item;
                 probeDistances_[currentIndex] = currentDistance;
                 numElements_++;
                 success = true;
                 break;
             }
-            size_t existingDistance = probeDistances_[currentIndex];
+            size_t existingDistance = distances[currentIndex];
             if (currentDistance > existingDistance) {
                 std::swap(item, *table_[currentIndex]);
                 std::swap(currentDistance, probeDistances_[currentIndex]);
+                totalDisplacements_++;
             } else {
                 totalCollisions_++;
             }
             currentDistance++;
         }
     } else if (currentMode_ == HashMode::Cuckoo) {
-        std::pair<Key, Value> item = {key, value};
         int evictions = 0;
-        while (evictions < MAX_EVICTIONS) {
+        while (evictions < config_.maxEvictions) {
             size_t idx1 = hash1(item.first);
             if (!table_[idx1] || isTombstone(table_[idx1])) {
                 table_[idx1] = item;
@@ -85,6 +177,7 @@ bool HybridHashTable<Key, Value>::insert(const Key& key, const Value& value) {
             }
             std::swap(item, *table_[idx1]);
             evictions++;
+            totalDisplacements_++;
             size_t idx2 = hash2(item.first);
             if (!table2_[idx2] || isTombstone(table2_[idx2])) {
                 table2_[idx2] = item;
@@ -94,59 +187,78 @@ bool HybridHashTable<Key, Value>::insert(const Key& key, const Value& value) {
             }
             std::swap(item, *table2_[idx2]);
             evictions++;
+            totalDisplacements_++;
             totalCollisions_++;
         }
     }
 
     if (!success) {
-        success = insertIntoStash(key, value);
+        success = insertIntoStash(item);
+        checkStashThreshold();
     }
 
     // Re-enable hybrid switching (safe, as load factor is computed without locking)
-    double currentLoad = static_cast<double>(numElements_) / (capacity_ + stash_.size());
+    //double currentLoad = static_cast<double>(numElements_) / (capacity_ + stash_->size());
     //switchModeIfNeeded(currentLoad);
     return success;
 }
 
 template <typename Key, typename Value>
 bool HybridHashTable<Key, Value>::remove(const Key& key) {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    SlowOpScope slowOp(*this, SlowOpType::Remove);
+    bool removed;
+    std::vector<TableEvent> events;
+    {
+        std::unique_lock<TableMutex> lock(mutex_);
+        slowOp.begin();
+        recordAccess(key);
+        traceAccess(TraceOp::Remove, key);
+        if (pinRefreshDue()) rebuildFrontTable();
+        unpin(key);
+        removed = removeInternal(key);
+        slowOp.end(&key);
+        events.swap(pendingEvents_);
+    }
+    dispatchEvents(events);
+    return removed;
+}
+
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::removeInternal(const Key& key) {
+    // Look up through const views, so a miss copies no segment a snapshot shares
+    const SegmentedArray<Slot>& table = table_;
+    const SegmentedArray<Slot>& table2 = table2_;
     if (currentMode_ == HashMode::Cuckoo) {
         size_t idx1 = hash1(key);
-        if (table_[idx1] && table_[idx1]->first == key) {
-            table_[idx1] = std::make_pair(TOMBSTONE, Value{});
+        if (table[idx1] && table[idx1]->first == key) {
+            table_[idx1] = Entry(TOMBSTONE, Value{});
             numElements_--;
             return true;
         }
         size_t idx2 = hash2(key);
-        if (table2_[idx2] && table2_[idx2]->first == key) {
-            table2_[idx2] = std::make_pair(TOMBSTONE, Value{});
+        if (table2[idx2] && table2[idx2]->first == key) {
+            table2_[idx2] = Entry(TOMBSTONE, Value{});
             numElements_--;
             return true;
         }
     } else if (currentMode_ == HashMode::Hopscotch) {
         size_t baseIndex = hash(key);
-        size_t start = getNeighborhoodStart(baseIndex);
-        size_t end = getNeighborhoodEnd(baseIndex);
-        uint32_t hopBitmap = hopInfo_[baseIndex];
-        for (size_t i = 0; i < HOP_RANGE && (start + i) < end; ++i) {
-            if (hopBitmap & (1U << i)) {
-                size_t checkIndex = start + i;
-                if (table_[checkIndex] && table_[checkIndex]->first == key) {
-                    table_[checkIndex] = std::make_pair(TOMBSTONE, Value{});
-                    updateHopInfo(baseIndex, checkIndex, false);
-                    numElements_--;
-                    return true;
-                }
-            }
+        const SegmentedArray<uint32_t>& hopInfo = hopInfo_;
+        size_t found = hopscotchProbe(hopInfo[baseIndex], getNeighborhoodStart(baseIndex), getNeighborhoodEnd(baseIndex),
+                                      config_.hopRange, [&](size_t i) { return table[i] && table[i]->first == key; });
+        if (found != HOPSCOTCH_NOT_FOUND) {
+            table_[found] = Entry(TOMBSTONE, Value{});
+            updateHopInfo(baseIndex, found, false);
+            numElements_--;
+            return true;
         }
     } else if (currentMode_ == HashMode::RobinHood) {
         size_t index = hash(key);
-        for (size_t probe = 0; probe < MAX_PROBE_DISTANCE; ++probe) {
+        for (size_t probe = 0; probe < config_.maxProbeDistance; ++probe) {
             size_t currentIndex = (index + probe) % capacity_;
-            if (!table_[currentIndex]) break;
-            if (table_[currentIndex]->first == key && !isTombstone(table_[currentIndex])) {
-                table_[currentIndex] = std::make_pair(TOMBSTONE, Value{});
+            if (!table[currentIndex]) break;
+            if (table[currentIndex]->first == key && !isTombstone(table[currentIndex])) {
+                table_[currentIndex] = Entry(TOMBSTONE, Value{});
                 probeDistances_[currentIndex] = 0;
                 numElements_--;
                 backwardShift(currentIndex);
@@ -159,82 +271,586 @@ bool HybridHashTable<Key, Value>::remove(const Key& key) {
 
 template <typename Key, typename Value>
 std::optional<Value> HybridHashTable<Key, Value>::search(const Key& key) const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);  // Shared lock for reads
-    return searchInternal(key);
+    SlowOpScope slowOp(*this, SlowOpType::Search);
+    std::optional<Value> result;
+    bool refreshDue;
+    {
+        std::shared_lock<TableMutex> lock(mutex_);  // Shared lock for reads
+        slowOp.begin();
+        recordAccess(key);
+        traceAccess(TraceOp::Search, key);
+        result = searchInternal(key);
+        refreshDue = pinRefreshDue();
+        slowOp.end(&key);
+    }
+    if (refreshDue) {
+        // Opportunistic: read-only workloads refresh the front table too, but never wait for it
+        std::unique_lock<TableMutex> lock(mutex_, std::try_to_lock);
+        if (lock.owns_lock() && pinRefreshDue()) rebuildFrontTable();
+    }
+    return result;
+}
+
+template <typename Key, typename Value>
+typename HybridHashTable<Key, Value>::ProbeHint HybridHashTable<Key, Value>::prefetchProbe(const Key& key) const {
+    ProbeHint hint;
+    hint.hash = hash_(key);
+    if (currentMode_ == HashMode::Cuckoo) {
+        hint.index1 = hash1(key);
+        hint.index2 = hash2(key);
+        __builtin_prefetch(&table_[hint.index1]);
+        __builtin_prefetch(&table2_[hint.index2]);
+    } else {
+        hint.index1 = hint.hash % capacity_;
+        hint.index2 = NO_INDEX;
+        if (currentMode_ == HashMode::Hopscotch) {
+            __builtin_prefetch(&hopInfo_[hint.index1]);
+            __builtin_prefetch(&table_[getNeighborhoodStart(hint.index1)]);  // First line of the neighborhood
+        }
+        __builtin_prefetch(&table_[hint.index1]);
+    }
+    return hint;
+}
+
+// Software-pipelined lookups: hint i + PREFETCH_DISTANCE is issued before probing i
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::lookupChunk(const std::vector<Key>& keys, std::vector<std::optional<Value>>& results) const {
+    results.clear();
+    results.reserve(keys.size());
+    bool refreshDue;
+    {
+        std::shared_lock<TableMutex> lock(mutex_);
+        ProbeHint window[PREFETCH_DISTANCE];
+        size_t ahead = keys.size() < PREFETCH_DISTANCE ? keys.size() : PREFETCH_DISTANCE;
+        for (size_t i = 0; i < ahead; ++i) window[i] = prefetchProbe(keys[i]);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            ProbeHint hint = window[i % PREFETCH_DISTANCE];
+            if (i + PREFETCH_DISTANCE < keys.size()) {
+                window[i % PREFETCH_DISTANCE] = prefetchProbe(keys[i + PREFETCH_DISTANCE]);
+            }
+            recordAccess(keys[i]);
+            if (trace_ && trace_->sample()) traceKey(*trace_, TraceOp::Search, hint.hash, keys[i]);
+            results.push_back(searchInternal(keys[i], hint));
+        }
+        refreshDue = pinRefreshDue();
+    }
+    if (refreshDue) {
+        std::unique_lock<TableMutex> lock(mutex_, std::try_to_lock);
+        if (lock.owns_lock() && pinRefreshDue()) rebuildFrontTable();
+    }
+}
+
+template <typename Key, typename Value>
+typename HybridHashTable<Key, Value>::ProbeHint HybridHashTable<Key, Value>::probeHint(const Key& key) const {
+    ProbeHint hint;
+    hint.hash = (currentMode_ != HashMode::Cuckoo || !frontTable_.empty()) ? hash_(key) : 0;
+    hint.index1 = currentMode_ == HashMode::Cuckoo ? hash1(key) : hint.hash % capacity_;
+    hint.index2 = NO_INDEX;  // Cuckoo: only hashed if the first table misses
+    return hint;
 }
 
 template <typename Key, typename Value>
 // Update search method (searchInternal):
 std::optional<Value> HybridHashTable<Key, Value>::searchInternal(const Key& key) const {
+    return searchInternal(key, probeHint(key));
+}
+
+template <typename Key, typename Value>
+std::optional<Value> HybridHashTable<Key, Value>::searchInternal(const Key& key, const ProbeHint& hint) const {
+    if (!frontTable_.empty()) {
+        if (const PinnedEntry* pinned = findPinned(key, hint.hash)) return pinned->value;
+    }
+    size_t index;
+    switch (findEntry(key, hint, index)) {
+        case EntryLocation::Table: return readValue(table_[index]->second);
+        case EntryLocation::Table2: return readValue(table2_[index]->second);
+        case EntryLocation::Stash: return readValue((*stash_)[index].second);
+        case EntryLocation::None: break;
+    }
+    return std::nullopt;
+}
+
+// Where key lives in the main structures (the front table is not consulted)
+template <typename Key, typename Value>
+typename HybridHashTable<Key, Value>::EntryLocation HybridHashTable<Key, Value>::findEntry(
+    const Key& key, const ProbeHint& hint, size_t& index) const {
     if (currentMode_ == HashMode::Cuckoo) {
-        size_t idx1 = hash1(key);
-        if (table_[idx1] && table_[idx1]->first == key && !isTombstone(table_[idx1])) return table_[idx1]->second;
-        size_t idx2 = hash2(key);
-        if (table2_[idx2] && table2_[idx2]->first == key && !isTombstone(table2_[idx2])) return table2_[idx2]->second;
+        index = hint.index1;
+        if (table_[index] && table_[index]->first == key && !isTombstone(table_[index])) return EntryLocation::Table;
+        index = hint.index2 != NO_INDEX ? hint.index2 : hash2(key);
+        if (table2_[index] && table2_[index]->first == key && !isTombstone(table2_[index])) return EntryLocation::Table2;
     } else if (currentMode_ == HashMode::Hopscotch) {
-        size_t baseIndex = hash(key);
-        size_t start = getNeighborhoodStart(baseIndex);
-        size_t end = getNeighborhoodEnd(baseIndex);
-        uint32_t hopBitmap = hopInfo_[baseIndex];
-        for (size_t i = 0; i < HOP_RANGE && (start + i) < end; ++i) {
-            if (hopBitmap & (1U << i)) {
-                size_t checkIndex = start + i;
-                if (table_[checkIndex] && table_[checkIndex]->first == key && !isTombstone(table_[checkIndex])) {
-                    return table_[checkIndex]->second;
-                }
-            }
-        }
+        size_t baseIndex = hint.index1;
+        index = hopscotchProbe(hopInfo_[baseIndex], getNeighborhoodStart(baseIndex), getNeighborhoodEnd(baseIndex),
+                               config_.hopRange, [&](size_t i) {
+                                   return table_[i] && table_[i]->first == key && !isTombstone(table_[i]);
+                               });
+        if (index != HOPSCOTCH_NOT_FOUND) return EntryLocation::Table;
     } else if (currentMode_ == HashMode::RobinHood) {
-        size_t index = hash(key);
-        for (size_t probe = 0; probe < MAX_PROBE_DISTANCE; ++probe) {
-            size_t currentIndex = (index + probe) % capacity_;
-            if (!table_[currentIndex]) break;
-            if (table_[currentIndex]->first == key && !isTombstone(table_[currentIndex])) {
-                return table_[currentIndex]->second;
-            }
+        for (size_t probe = 0; probe < config_.maxProbeDistance; ++probe) {
+            index = (hint.index1 + probe) % capacity_;
+            if (!table_[index]) break;
+            if (table_[index]->first == key && !isTombstone(table_[index])) return EntryLocation::Table;
         }
     }
-    return searchStash(key);
+    for (index = 0; index < stash_->size(); ++index) {
+        if ((*stash_)[index].first == key) return EntryLocation::Stash;
+    }
+    return EntryLocation::None;
+}
+
+template <typename Key, typename Value>
+const typename HybridHashTable<Key, Value>::PinnedEntry* HybridHashTable<Key, Value>::findPinned(const Key& key,
+                                                                                                  size_t hash) const {
+    for (const auto& pinned : frontTable_) {
+        if (pinned.hash == hash && pinned.key == key) return &pinned;
+    }
+    return nullptr;
+}
+
+// Shared lock: the value can be updated in place only if its segment (or the stash)
+// is not shared with a snapshot and no front-table copy has to follow it
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::sharedEntrySlot(const Key& key, Entry*& entry) const {
+    ProbeHint hint = probeHint(key);
+    if (!frontTable_.empty() && findPinned(key, hint.hash)) {
+        entry = nullptr;
+        return true;
+    }
+    size_t index;
+    Slot* slot = nullptr;
+    switch (findEntry(key, hint, index)) {
+        case EntryLocation::Table: slot = table_.ownedSlot(index); break;
+        case EntryLocation::Table2: slot = table2_.ownedSlot(index); break;
+        case EntryLocation::Stash:
+            entry = stash_.use_count() == 1 ? &(*stash_)[index] : nullptr;
+            return true;
+        case EntryLocation::None: return false;
+    }
+    entry = slot ? &**slot : nullptr;
+    return true;
+}
+
+// Exclusive lock: take private copies as needed and return the entry to update
+template <typename Key, typename Value>
+typename HybridHashTable<Key, Value>::Entry* HybridHashTable<Key, Value>::exclusiveEntrySlot(const Key& key) {
+    size_t index;
+    switch (findEntry(key, probeHint(key), index)) {
+        case EntryLocation::Table: return &*table_[index];
+        case EntryLocation::Table2: return &*table2_[index];
+        case EntryLocation::Stash: return &mutableStash()[index];
+        case EntryLocation::None: break;
+    }
+    return nullptr;
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::syncPinned(const Key& key, const Value& value) {
+    for (auto& pinned : frontTable_) {
+        if (pinned.key == key) pinned.value = value;
+    }
+}
+
+template <typename Key, typename Value>
+std::optional<typename HybridHashTable<Key, Value>::Versioned> HybridHashTable<Key, Value>::searchVersioned(
+    const Key& key) const {
+    std::shared_lock<TableMutex> lock(mutex_);
+    recordAccess(key);
+    traceAccess(TraceOp::Search, key);
+    size_t index;
+    const Entry* entry = nullptr;
+    switch (findEntry(key, probeHint(key), index)) {
+        case EntryLocation::Table: entry = &*table_[index]; break;
+        case EntryLocation::Table2: entry = &*table2_[index]; break;
+        case EntryLocation::Stash: entry = &(*stash_)[index]; break;
+        case EntryLocation::None: return std::nullopt;
+    }
+    // Version first: atomic updates publish the value before the version
+    uint64_t version = __atomic_load_n(&entry->version, __ATOMIC_ACQUIRE);
+    return Versioned{readValue(entry->second), version};
+}
+
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::updateIfVersion(const Key& key, const Value& desired, uint64_t expectedVersion) {
+    SlowOpScope slowOp(*this, SlowOpType::Update);
+    std::unique_lock<TableMutex> lock(mutex_);
+    slowOp.begin();
+    recordAccess(key);
+    traceAccess(TraceOp::Update, key);
+    Entry* entry = exclusiveEntrySlot(key);
+    bool updated = entry && entry->version == expectedVersion;
+    if (updated) {
+        entry->second = desired;
+        entry->version = nextVersion();
+        syncPinned(key, desired);
+    }
+    slowOp.end(&key);
+    return updated;
+}
+
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::compareAndSet(const Key& key, const Value& expected, const Value& desired) {
+    SlowOpScope slowOp(*this, SlowOpType::Update);
+    std::unique_lock<TableMutex> lock(mutex_);
+    slowOp.begin();
+    recordAccess(key);
+    traceAccess(TraceOp::Update, key);
+    Entry* entry = exclusiveEntrySlot(key);
+    bool updated = entry && entry->second == expected;
+    if (updated) {
+        entry->second = desired;
+        entry->version = nextVersion();
+        syncPinned(key, desired);
+    }
+    slowOp.end(&key);
+    return updated;
 }
 
 template <typename Key, typename Value>
 size_t HybridHashTable<Key, Value>::size() const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);  // Shared lock for reads
+    std::shared_lock<TableMutex> lock(mutex_);  // Shared lock for reads
     return numElements_;
 }
 
 template <typename Key, typename Value>
 double HybridHashTable<Key, Value>::loadFactor() const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);  // Shared lock for reads
-    return static_cast<double>(numElements_) / (capacity_ + stash_.size());
+    std::shared_lock<TableMutex> lock(mutex_);  // Shared lock for reads
+    return static_cast<double>(numElements_) / (capacity_ + stash_->size());
+}
+
+template <typename Key, typename Value>
+size_t HybridHashTable<Key, Value>::capacity() const {
+    std::shared_lock<TableMutex> lock(mutex_);  // Shared lock for reads
+    return capacity_;
+}
+
+template <typename Key, typename Value>
+HashMode HybridHashTable<Key, Value>::mode() const {
+    std::shared_lock<TableMutex> lock(mutex_);  // Shared lock for reads
+    return currentMode_;
 }
 
 template <typename Key, typename Value>
-void HybridHashTable<Key, Value>::resize(size_t newSize) {
-    std::unique_lock<std::shared_mutex> lock(mutex_);  // Exclusive lock for writes
-    capacity_ = newSize;
-    rehash();
+HashTableConfig HybridHashTable<Key, Value>::config() const {
+    std::shared_lock<TableMutex> lock(mutex_);  // Shared lock for reads
+    return config_;
+}
+
+template <typename Key, typename Value>
+typename HybridHashTable<Key, Value>::Snapshot HybridHashTable<Key, Value>::snapshot() const {
+    // Exclusive but O(1): sharing the segments marks them copy-on-write for the next writer
+    std::unique_lock<TableMutex> lock(mutex_);
+    return Snapshot(new HybridHashTable(*this));
+}
+
+template <typename Key, typename Value>
+std::unique_ptr<HybridHashTable<Key, Value>> HybridHashTable<Key, Value>::clone(CloneMode mode, ThreadPool* pool) const {
+    std::unique_ptr<HybridHashTable> copy;
+    {
+        std::unique_lock<TableMutex> lock(mutex_);  // Same O(1) sharing as snapshot()
+        copy.reset(new HybridHashTable(*this));
+    }
+    copy->frontTable_.clear();  // Pinned entries are duplicates of table entries; the copy tracks no hot keys
+    if (mode == CloneMode::Deep) {
+        // Readers continue; writers wait so that the references the copy drops are
+        // ordered before the source next writes those segments in place
+        std::shared_lock<TableMutex> lock(mutex_);
+        std::shared_ptr<ThreadPool> defaultPool = pool ? nullptr : ThreadPool::defaultPool();
+        ThreadPool& workers = pool ? *pool : *defaultPool;
+        copy->table_.detach(workers);
+        copy->table2_.detach(workers);
+        copy->hopInfo_.detach(workers);
+        copy->probeDistances_.detach(workers);
+        copy->stash_ = std::make_shared<Stash>(*copy->stash_);
+    }
+    return copy;
+}
+
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::resize(size_t newSize) {
+    SlowOpScope slowOp(*this, SlowOpType::Resize);
+    std::vector<TableEvent> events;
+    bool allowed;
+    {
+        std::shared_lock<TableMutex> lock(mutex_);
+        allowed = newSize <= capacity_ || governorAllows(newSize, currentMode_);  // Shrinking is always allowed
+        if (allowed) {
+            TableEvent begin = makeEvent(TableEventType::ResizeBegin);
+            begin.newCapacity = newSize;
+            events.push_back(begin);
+        }
+    }
+    if (!allowed) {
+        {
+            std::unique_lock<TableMutex> lock(mutex_);
+            refuseGrowth(newSize);
+            events.swap(pendingEvents_);
+        }
+        dispatchEvents(events);
+        return false;
+    }
+    dispatchEvents(events);
+    events.clear();
+    bool resized;
+    {
+        std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+        slowOp.begin();
+        auto start = std::chrono::steady_clock::now();
+        size_t oldCapacity = capacity_;
+        resized = rehash(std::max<size_t>(newSize, 1));
+        slowOp.resized();
+        slowOp.end(nullptr);
+        TableEvent end = makeEvent(TableEventType::ResizeEnd);
+        end.oldCapacity = oldCapacity;
+        end.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        pendingEvents_.push_back(end);
+        events.swap(pendingEvents_);
+    }
+    dispatchEvents(events);
+    return resized;
 }
 
 template <typename Key, typename Value>
 void HybridHashTable<Key, Value>::setMode(HashMode mode) {
-    std::unique_lock<std::shared_mutex> lock(mutex_);  // Exclusive lock for writes
-    currentMode_ = mode;
-    table_.assign(capacity_, std::nullopt);
-    table2_.assign(capacity_, std::nullopt);
-    hopInfo_.assign(capacity_, 0);
-    probeDistances_.assign(capacity_, 0);
-    stash_.clear();
-    numElements_ = 0;
+    std::vector<TableEvent> events;
+    {
+        std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+        auto start = std::chrono::steady_clock::now();
+        HashMode oldMode = currentMode_;
+        currentMode_ = mode;
+        clearSlots();
+        frontTable_.clear();
+        checkStashThreshold();
+        TableEvent event = makeEvent(TableEventType::ModeSwitch);
+        event.oldMode = oldMode;
+        event.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        pendingEvents_.push_back(event);
+        events.swap(pendingEvents_);
+    }
+    dispatchEvents(events);
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::clear() {
+    std::vector<TableEvent> events;
+    {
+        std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+        clearSlots();
+        frontTable_.clear();
+        checkStashThreshold();
+        events.swap(pendingEvents_);
+    }
+    dispatchEvents(events);
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::reseed(uint64_t seed) {
+    std::vector<TableEvent> events;
+    {
+        std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+        auto start = std::chrono::steady_clock::now();
+        auto oldHash = hash_, oldHash1 = hash1_, oldHash2 = hash2_;
+        hash_ = [seed](const Key& key) { return HashUtils::mix(HashUtils::hash(key) ^ seed); };
+        hash1_ = [seed](const Key& key) { return HashUtils::mix(HashUtils::hash1(key) ^ seed); };
+        hash2_ = [seed](const Key& key) { return HashUtils::mix(HashUtils::hash2(key) ^ ~seed); };
+        if (rehash(capacity_)) {
+            TableEvent event = makeEvent(TableEventType::Reseed);
+            event.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            pendingEvents_.push_back(event);
+        } else {
+            // The old layout was kept, so it must be probed with the old functions
+            hash_ = std::move(oldHash);
+            hash1_ = std::move(oldHash1);
+            hash2_ = std::move(oldHash2);
+            rebuildFrontTable();
+        }
+        events.swap(pendingEvents_);
+    }
+    dispatchEvents(events);
+}
+
+template <typename Key, typename Value>
+size_t HybridHashTable<Key, Value>::addObserver(TableObserver observer) {
+    std::lock_guard<std::mutex> lock(observersMutex_);
+    auto observers = observers_ ? std::make_shared<ObserverList>(*observers_) : std::make_shared<ObserverList>();
+    size_t id = nextObserverId_++;
+    observers->emplace_back(id, std::move(observer));
+    observers_ = std::move(observers);
+    return id;
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::removeObserver(size_t id) {
+    std::lock_guard<std::mutex> lock(observersMutex_);
+    if (!observers_) return;
+    auto observers = std::make_shared<ObserverList>(*observers_);
+    observers->erase(std::remove_if(observers->begin(), observers->end(),
+                                    [id](const auto& entry) { return entry.first == id; }),
+                     observers->end());
+    observers_ = std::move(observers);
+}
+
+template <typename Key, typename Value>
+TableEvent HybridHashTable<Key, Value>::makeEvent(TableEventType type) const {
+    return {type, capacity_, capacity_, currentMode_, currentMode_, numElements_, stash_->size(), 0.0};
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::checkStashThreshold() {
+    bool above = stash_->size() >= config_.stashEventThreshold;
+    if (above == stashAboveThreshold_) return;
+    stashAboveThreshold_ = above;
+    pendingEvents_.push_back(makeEvent(above ? TableEventType::StashAboveThreshold : TableEventType::StashBelowThreshold));
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::dispatchEvents(const std::vector<TableEvent>& events) {
+    if (events.empty()) return;
+    std::shared_ptr<const ObserverList> observers;
+    {
+        std::lock_guard<std::mutex> lock(observersMutex_);
+        observers = observers_;
+    }
+    if (!observers) return;
+    for (const auto& event : events) {
+        for (const auto& entry : *observers) entry.second(event);
+    }
+}
+
+// Called under the exclusive lock after an insert; true if this caller must grow the table
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::claimGrowth() {
+    if (growthClaimed_) return false;
+    if (static_cast<double>(numElements_) <= config_.maxLoadFactor * capacity_) return false;
+    if ((governor_ || failedRehashes_) && std::chrono::steady_clock::now() < growthRetryAt_) return false;  // Refused or failed recently
+    growthClaimed_ = true;
+    return true;
+}
+
+// Automatic doubling. ResizeBegin is delivered before the rehash starts, outside the lock.
+// If the memory governor refuses the doubling, the memory policy applies instead.
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::grow() {
+    std::vector<TableEvent> events;
+    size_t oldCapacity;
+    bool allowed;
+    {
+        std::shared_lock<TableMutex> lock(mutex_);
+        oldCapacity = capacity_;
+        allowed = governorAllows(oldCapacity * 2, currentMode_);
+        if (allowed) {
+            TableEvent begin = makeEvent(TableEventType::ResizeBegin);
+            begin.newCapacity = oldCapacity * 2;
+            events.push_back(begin);
+        }
+    }
+    if (!allowed) {
+        {
+            std::unique_lock<TableMutex> lock(mutex_);
+            if (capacity_ == oldCapacity) {
+                refuseGrowth(oldCapacity * 2);
+                applyMemoryPolicy();
+            }
+            growthClaimed_ = false;
+            events.swap(pendingEvents_);
+        }
+        dispatchEvents(events);
+        return;
+    }
+    dispatchEvents(events);
+    events.clear();
+    {
+        std::unique_lock<TableMutex> lock(mutex_);
+        auto start = std::chrono::steady_clock::now();
+        // Unless an explicit resize got there first; a failed doubling backs off like a refused one
+        if (capacity_ == oldCapacity && !rehash(oldCapacity * 2)) {
+            growthRetryAt_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(GROWTH_RETRY_MS);
+        }
+        growthClaimed_ = false;
+        TableEvent end = makeEvent(TableEventType::ResizeEnd);
+        end.oldCapacity = oldCapacity;
+        end.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        pendingEvents_.push_back(end);
+        events.swap(pendingEvents_);
+    }
+    dispatchEvents(events);
+}
+
+template <typename Key, typename Value>
+typename HybridHashTable<Key, Value>::Stats HybridHashTable<Key, Value>::stats() const {
+    std::shared_lock<TableMutex> lock(mutex_);  // Shared lock for reads
+    Stats s;
+    s.size = numElements_;
+    s.capacity = capacity_;
+    s.loadFactor = computeLoadFactor();
+    s.mode = currentMode_;
+    s.stashSize = stash_->size();
+    s.totalInsertions = totalInsertions_;
+    s.totalCollisions = totalCollisions_;
+    s.totalProbes = totalProbes_;
+    if (hotKeys_) s.hotKeys = hotKeys_->topK(std::max<size_t>(maxPinnedKeys_, 16));
+    for (const auto& pinned : frontTable_) s.pinnedKeys.push_back(pinned.key);
+    s.lock = lockStats(mutex_);
+    s.memoryBytes = slotBytes(capacity_, currentMode_) + stash_->capacity() * sizeof(Entry);
+    s.memoryHeadroom = governor_ ? governor_->headroom() : SIZE_MAX;
+    s.refusedGrowths = refusedGrowths_;
+    s.failedRehashes = failedRehashes_;
+    s.evictions = evictions_;
+    return s;
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::setMemoryGovernor(std::shared_ptr<const MemoryGovernor> governor, MemoryPolicy policy) {
+    std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+    governor_ = std::move(governor);
+    memoryPolicy_ = policy;
+    evicting_ = false;
+    growthRetryAt_ = std::chrono::steady_clock::time_point();
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::enableHotKeyTracking(size_t sampleRate, size_t trackedKeys, size_t pinnedKeys) {
+    std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+    hotKeys_ = std::make_unique<HotKeyTracker<Key>>(std::max(trackedKeys, pinnedKeys), sampleRate);
+    maxPinnedKeys_ = pinnedKeys;
+    nextPinRefresh_ = PIN_REFRESH_SAMPLES;
+    frontTable_.clear();
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::disableHotKeyTracking() {
+    std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+    hotKeys_.reset();
+    maxPinnedKeys_ = 0;
+    frontTable_.clear();
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::setTraceRecorder(std::shared_ptr<TraceRecorder> recorder) {
+    std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+    trace_ = std::move(recorder);
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::setSlowOpRecorder(std::shared_ptr<SlowOpRecorder> recorder) {
+    std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+    recordSlowOps_.store(recorder != nullptr, std::memory_order_relaxed);
+    slowOps_ = std::move(recorder);
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::refreshHotKeys() {
+    std::unique_lock<TableMutex> lock(mutex_);  // Exclusive lock for writes
+    rebuildFrontTable();
 }
 
 template <typename Key, typename Value>
 // Update switchModeIfNeeded to take load factor as param
 void HybridHashTable<Key, Value>::switchModeIfNeeded(double currentLoad) {
     double collRate = collisionRate();
-    if (currentLoad > HIGH_LOAD_THRESHOLD && currentMode_ != HashMode::RobinHood) {
+    if (currentLoad > config_.highLoadThreshold && currentMode_ != HashMode::RobinHood) {
         setMode(HashMode::RobinHood);
-    } else if (collRate > HIGH_COLLISION_RATE && currentMode_ != HashMode::Cuckoo) {
+    } else if (collRate > config_.highCollisionRate && currentMode_ != HashMode::Cuckoo) {
         setMode(HashMode::Cuckoo);
     } else if (currentLoad < 0.5 && currentMode_ != HashMode::Hopscotch) {
         setMode(HashMode::Hopscotch);
@@ -247,11 +863,12 @@ void HybridHashTable<Key, Value>::switchModeIfNeeded(double currentLoad) {
 // Helpers
 template <typename Key, typename Value>
 void HybridHashTable<Key, Value>::backwardShift(size_t startIndex) {
+    const SegmentedArray<Slot>& table = table_;  // The slot that ends the shift is only read
     size_t currentIndex = startIndex;
     for (size_t probe = 1; probe < capacity_; ++probe) {
         size_t nextIndex = (startIndex + probe) % capacity_;
-        if (!table_[nextIndex] || isTombstone(table_[nextIndex])) break;
-        size_t nextIdeal = hash(table_[nextIndex]->first);
+        if (!table[nextIndex] || isTombstone(table[nextIndex])) break;
+        size_t nextIdeal = hash(table[nextIndex]->first);
         size_t nextDistance = getProbeDistance(nextIdeal, nextIndex);
         if (nextDistance == 0) break;
         table_[currentIndex] = *table_[nextIndex];
@@ -263,27 +880,21 @@ void HybridHashTable<Key, Value>::backwardShift(size_t startIndex) {
 }
 
 template <typename Key, typename Value>
-bool HybridHashTable<Key, Value>::insertIntoStash(const Key& key, const Value& value) {
-    if (stash_.size() >= MAX_STASH_SIZE) return false;
-    stash_.emplace_back(key, value);
+bool HybridHashTable<Key, Value>::insertIntoStash(const Entry& entry) {
+    if (stash_->size() >= MAX_STASH_SIZE) return false;
+    mutableStash().push_back(entry);
     numElements_++;
     return true;
 }
 
-template <typename Key, typename Value>
-std::optional<Value> HybridHashTable<Key, Value>::searchStash(const Key& key) const {
-    for (const auto& item : stash_) {
-        if (item.first == key) return item.second;
-    }
-    return std::nullopt;
-}
-
 template <typename Key, typename Value>
 bool HybridHashTable<Key, Value>::removeFromStash(const Key& key) {
-    for (auto it = stash_.begin(); it != stash_.end(); ++it) {
-        if (it->first == key) {
-            stash_.erase(it);
+    for (size_t i = 0; i < stash_->size(); ++i) {
+        if ((*stash_)[i].first == key) {
+            Stash& stash = mutableStash();
+            stash.erase(stash.begin() + i);
             numElements_--;
+            checkStashThreshold();
             return true;
         }
     }
@@ -291,24 +902,298 @@ bool HybridHashTable<Key, Value>::removeFromStash(const Key& key) {
 }
 
 template <typename Key, typename Value>
-void HybridHashTable<Key, Value>::rehash() {
-    std::vector<std::pair<Key, Value>> allElements;
-    for (const auto& slot : table_) {
+void HybridHashTable<Key, Value>::rebuildFrontTable() const {
+    frontTable_.clear();
+    if (!hotKeys_ || maxPinnedKeys_ == 0) return;
+    nextPinRefresh_ = hotKeys_->samples() + PIN_REFRESH_SAMPLES;
+    for (const auto& hot : hotKeys_->topK(maxPinnedKeys_)) {
+        std::optional<Value> value = searchInternal(hot.key);
+        if (value) frontTable_.push_back({hash_(hot.key), hot.key, *value});
+    }
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::unpin(const Key& key) {
+    for (auto it = frontTable_.begin(); it != frontTable_.end(); ++it) {
+        if (it->key == key) {
+            frontTable_.erase(it);
+            return;
+        }
+    }
+}
+
+template <typename Key, typename Value>
+typename HybridHashTable<Key, Value>::Stash& HybridHashTable<Key, Value>::mutableStash() {
+    if (stash_.use_count() > 1) stash_ = std::make_shared<Stash>(*stash_);
+    return *stash_;
+}
+
+// Rebuild at newCapacity; caller holds the exclusive lock
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::rehash(size_t newCapacity) {
+    return rehash(newCapacity, currentMode_);
+}
+
+// The old arrays are kept (shared, so this is O(segments)) until every entry is
+// placed; if the stash overflows, they are restored and RehashFailed fires
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::rehash(size_t newCapacity, HashMode mode) {
+    size_t before = numElements_;
+    size_t oldCapacity = capacity_;
+    HashMode oldMode = currentMode_;
+    bool wasEvicting = evicting_;
+    SegmentedArray<Slot> oldTable = table_;
+    SegmentedArray<Slot> oldTable2 = table2_;
+    SegmentedArray<uint32_t> oldHopInfo = hopInfo_;
+    SegmentedArray<size_t> oldDistances = probeDistances_;
+    std::shared_ptr<Stash> oldStash = stash_;
+    if (numElements_ >= PARALLEL_REHASH_MIN) {
+        std::shared_ptr<ThreadPool> pool = ThreadPool::defaultPool();
+        parallelRehash(newCapacity, mode, *pool);
+    } else {
+        rehashInPlace(newCapacity, mode);
+    }
+    bool kept = numElements_ == before;
+    if (!kept) {
+        table_ = std::move(oldTable);
+        table2_ = std::move(oldTable2);
+        hopInfo_ = std::move(oldHopInfo);
+        probeDistances_ = std::move(oldDistances);
+        stash_ = std::move(oldStash);
+        capacity_ = oldCapacity;
+        currentMode_ = oldMode;
+        evicting_ = wasEvicting;
+        numElements_ = before;
+        failedRehashes_++;
+        checkStashThreshold();
+        TableEvent event = makeEvent(TableEventType::RehashFailed);
+        event.newCapacity = newCapacity;
+        event.newMode = mode;
+        pendingEvents_.push_back(event);
+    }
+    rebuildFrontTable();  // Pinned hashes are stale after a reseed
+    return kept;
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::rehashInPlace(size_t newCapacity, HashMode mode) {
+    // Read through const views: the old arrays are dropped, so unwritten segments must not be materialized
+    const SegmentedArray<Slot>& oldTable = table_;
+    const SegmentedArray<Slot>& oldTable2 = table2_;
+    std::vector<Entry> allElements;
+    allElements.reserve(numElements_);
+    for (size_t i = 0; i < oldTable.size(); ++i) {
+        const Slot& slot = oldTable[i];
         if (slot && !isTombstone(slot)) allElements.push_back(*slot);
     }
-    allElements.insert(allElements.end(), stash_.begin(), stash_.end());
+    if (currentMode_ == HashMode::Cuckoo) {
+        for (size_t i = 0; i < oldTable2.size(); ++i) {
+            const Slot& slot = oldTable2[i];
+            if (slot && !isTombstone(slot)) allElements.push_back(*slot);
+        }
+    }
+    allElements.insert(allElements.end(), stash_->begin(), stash_->end());
+
+    if (newCapacity > capacity_) evicting_ = false;  // Room again: stop evicting
+    capacity_ = newCapacity;
+    currentMode_ = mode;
+    clearSlots();
+
+    for (const auto& elem : allElements) {
+        insertInternal(elem.first, elem.second, elem.version);  // Rehashing keeps versions
+    }
+    checkStashThreshold();
+}
+
+// Rehash on the pool. Entries are hashed for the new layout and bucketed by
+// destination range in parallel; then one worker fills each range without locks,
+// because every placement stays inside it: Hopscotch ranges are whole
+// neighborhoods, Robin Hood places a range's entries in home order (a valid Robin
+// Hood layout), and Cuckoo only fills first-table slots. Entries that do not fit in
+// their range are inserted one by one at the end.
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::parallelRehash(size_t newCapacity, HashMode mode, ThreadPool& pool) {
+    struct Placed {
+        Entry entry;
+        size_t home;
+    };
+    using Buckets = std::vector<std::vector<Placed>>;
+
+    // Destination ranges, aligned to neighborhoods for Hopscotch
+    size_t unit = mode == HashMode::Hopscotch ? config_.hopRange : 1;
+    size_t units = (newCapacity + unit - 1) / unit;
+    size_t parts = std::min(units, pool.size() * REHASH_PARTS_PER_THREAD);
+    size_t rangeSlots = (units + parts - 1) / parts * unit;
+    parts = (newCapacity + rangeSlots - 1) / rangeSlots;
+
+    // Collect: read the old arrays through const views, in input chunks
+    const SegmentedArray<Slot>& oldTable = table_;
+    const SegmentedArray<Slot>& oldTable2 = table2_;
+    const Stash& oldStash = *stash_;
+    size_t oldSlots = oldTable.size() + (currentMode_ == HashMode::Cuckoo ? oldTable2.size() : 0);
+    size_t inputs = oldSlots + oldStash.size();
+    size_t chunks = pool.size() * REHASH_PARTS_PER_THREAD;
+    std::vector<Buckets> collected(chunks, Buckets(parts));
+    pool.parallelFor(0, chunks, 1, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            for (size_t i = c * inputs / chunks; i < (c + 1) * inputs / chunks; ++i) {
+                const Entry* entry;
+                if (i < oldSlots) {
+                    const Slot& slot = i < oldTable.size() ? oldTable[i] : oldTable2[i - oldTable.size()];
+                    if (!slot || isTombstone(slot)) continue;
+                    entry = &*slot;
+                } else {
+                    entry = &oldStash[i - oldSlots];
+                }
+                size_t home = (mode == HashMode::Cuckoo ? hash1_(entry->first) : hash_(entry->first)) % newCapacity;
+                collected[c][home / rangeSlots].push_back({*entry, home});
+            }
+        }
+    });
+
+    if (newCapacity > capacity_) evicting_ = false;  // Room again: stop evicting
+    capacity_ = newCapacity;
+    currentMode_ = mode;
+    clearSlots();
+    // Private segments everywhere, so concurrent writes to distinct slots are safe
+    table_.materialize(pool);
+    if (mode == HashMode::Hopscotch) hopInfo_.materialize(pool);
+    if (mode == HashMode::RobinHood) probeDistances_.materialize(pool);
+
+    // Place: one range per task
+    std::vector<std::vector<Placed>> leftovers(parts);
+    std::vector<size_t> placed(parts, 0);
+    pool.parallelFor(0, parts, 1, [&](size_t first, size_t last) {
+        for (size_t p = first; p < last; ++p) {
+            std::vector<Placed> entries;
+            for (Buckets& buckets : collected) {
+                for (Placed& item : buckets[p]) entries.push_back(std::move(item));
+                std::vector<Placed>().swap(buckets[p]);
+            }
+            size_t rangeEnd = std::min((p + 1) * rangeSlots, capacity_);
+            size_t next = p * rangeSlots;  // Robin Hood: first free slot
+            if (mode == HashMode::RobinHood) {
+                std::sort(entries.begin(), entries.end(), [](const Placed& a, const Placed& b) { return a.home < b.home; });
+            }
+            for (Placed& item : entries) {
+                size_t slot = capacity_;
+                if (mode == HashMode::Hopscotch) {
+                    slot = findEmptySlot(getNeighborhoodStart(item.home), getNeighborhoodEnd(item.home));
+                    if (slot != capacity_) updateHopInfo(item.home, slot, true);
+                } else if (mode == HashMode::RobinHood) {
+                    size_t pos = std::max(item.home, next);
+                    if (pos < rangeEnd && pos - item.home < config_.maxProbeDistance) {
+                        slot = pos;
+                        probeDistances_[slot] = pos - item.home;
+                        next = pos + 1;
+                    }
+                } else if (!table_[item.home]) {
+                    slot = item.home;
+                }
+                if (slot == capacity_) {
+                    leftovers[p].push_back(std::move(item));
+                    continue;
+                }
+                table_[slot] = std::move(item.entry);
+                placed[p]++;
+            }
+        }
+    });
+
+    for (size_t count : placed) numElements_ += count;
+    for (auto& range : leftovers) {
+        for (const Placed& item : range) insertInternal(item.entry.first, item.entry.second, item.entry.version);
+    }
+    checkStashThreshold();
+}
 
-    capacity_ *= 2;
+// Empty every slot at the current capacity. The arrays refill lazily, one segment
+// per first write, so this is O(capacity / SEGMENT_SIZE) rather than a full pass.
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::clearSlots() {
     table_.assign(capacity_, std::nullopt);
     table2_.assign(capacity_, std::nullopt);
     hopInfo_.assign(capacity_, 0);
     probeDistances_.assign(capacity_, 0);
-    stash_.clear();
+    stash_ = std::make_shared<Stash>();
     numElements_ = 0;
+}
 
-    for (const auto& elem : allElements) {
-        insert(elem.first, elem.second);
+template <typename Key, typename Value>
+size_t HybridHashTable<Key, Value>::slotBytes(size_t capacity, HashMode mode) const {
+    size_t perSlot = sizeof(Slot);
+    if (mode == HashMode::Cuckoo) perSlot += sizeof(Slot);
+    else if (mode == HashMode::Hopscotch) perSlot += sizeof(uint32_t);
+    else perSlot += sizeof(size_t);
+    return capacity * perSlot;
+}
+
+// Extra memory at the peak of a rehash: the copied entries plus the new arrays
+// (the old ones are kept until every entry is placed, for the rollback)
+template <typename Key, typename Value>
+size_t HybridHashTable<Key, Value>::rehashBytes(size_t newCapacity, HashMode mode) const {
+    return numElements_ * sizeof(Entry) + slotBytes(newCapacity, mode);
+}
+
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::governorAllows(size_t newCapacity, HashMode mode) const {
+    return !governor_ || governor_->allows(rehashBytes(newCapacity, mode));
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::refuseGrowth(size_t newCapacity) {
+    refusedGrowths_++;
+    growthRetryAt_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(GROWTH_RETRY_MS);
+    TableEvent event = makeEvent(TableEventType::GrowthRefused);
+    event.newCapacity = newCapacity;
+    pendingEvents_.push_back(event);
+}
+
+template <typename Key, typename Value>
+void HybridHashTable<Key, Value>::applyMemoryPolicy() {
+    if (memoryPolicy_ == MemoryPolicy::Evict) {
+        evicting_ = true;
+    } else if (memoryPolicy_ == MemoryPolicy::SwitchMode && currentMode_ != HashMode::RobinHood) {
+        // Keep every slot: cuckoo's two tables become one Robin Hood table of twice the capacity
+        size_t slots = currentMode_ == HashMode::Cuckoo ? 2 * capacity_ : capacity_;
+        if (static_cast<double>(numElements_) > SWITCH_MODE_MAX_LOAD * slots) return;  // Would overflow to the stash
+        if (!governorAllows(slots, HashMode::RobinHood)) return;  // Copying the entries does not fit either
+        auto start = std::chrono::steady_clock::now();
+        HashMode oldMode = currentMode_;
+        if (!rehash(slots, HashMode::RobinHood)) return;
+        TableEvent event = makeEvent(TableEventType::ModeSwitch);
+        event.oldMode = oldMode;
+        event.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        pendingEvents_.push_back(event);
+    }
+}
+
+// Drop one resident entry: the stash first, then round-robin over the slots
+template <typename Key, typename Value>
+bool HybridHashTable<Key, Value>::evictOne() {
+    Key victim;
+    bool found = false;
+    if (!stash_->empty()) {
+        victim = stash_->back().first;
+        found = true;
+    } else {
+        const SegmentedArray<Slot>& table = table_;
+        const SegmentedArray<Slot>& table2 = table2_;
+        size_t slots = currentMode_ == HashMode::Cuckoo ? 2 * capacity_ : capacity_;
+        for (size_t n = 0; n < slots && !found; ++n) {
+            size_t i = evictCursor_++ % slots;
+            const Slot& slot = i < capacity_ ? table[i] : table2[i - capacity_];
+            if (slot && !isTombstone(slot)) {
+                victim = slot->first;
+                found = true;
+            }
+        }
     }
+    if (!found) return false;
+    unpin(victim);
+    removeInternal(victim);
+    evictions_++;
+    return true;
 }
 
 template <typename Key, typename Value>
@@ -320,7 +1205,7 @@ void HybridHashTable<Key, Value>::updateHopInfo(size_t baseIndex, size_t targetI
 }
 
 template <typename Key, typename Value>
-size_t HybridHashTable<Key, Value>::findEmptySlot(size_t start, size_t end) {
+size_t HybridHashTable<Key, Value>::findEmptySlot(size_t start, size_t end) const {
     for (size_t i = start; i < end; ++i) {
         if (!table_[i] || isTombstone(table_[i])) return i;
     }
@@ -329,10 +1214,11 @@ size_t HybridHashTable<Key, Value>::findEmptySlot(size_t start, size_t end) {
 
 template <typename Key, typename Value>
 bool HybridHashTable<Key, Value>::displace(size_t index) {
-    for (size_t d = 1; d <= MAX_DISPLACEMENTS; ++d) {
+    const SegmentedArray<Slot>& table = table_;  // Candidates are only read; the two slots of a move are written
+    for (size_t d = 1; d <= config_.maxDisplacements; ++d) {
         size_t checkIndex = (index + d) % capacity_;
-        if (table_[checkIndex] && !isTombstone(table_[checkIndex])) {
-            size_t targetBase = hash(table_[checkIndex]->first);
+        if (table[checkIndex] && !isTombstone(table[checkIndex])) {
+            size_t targetBase = hash(table[checkIndex]->first);
             size_t targetStart = getNeighborhoodStart(targetBase);
             size_t targetEnd = getNeighborhoodEnd(targetBase);
             if (checkIndex >= targetStart && checkIndex < targetEnd) {
@@ -342,6 +1228,7 @@ bool HybridHashTable<Key, Value>::displace(size_t index) {
                     table_[checkIndex] = std::nullopt;
                     updateHopInfo(targetBase, checkIndex, false);
                     updateHopInfo(targetBase, emptyIndex, true);
+                    totalDisplacements_++;
                     return true;
                 }
             }
@@ -0,0 +1,110 @@
+#include "LockProfiler.hpp"
+
+#ifdef HYBRID_HASH_LOCK_PROFILING
+
+#include <chrono>
+#include <vector>
+#include <utility>
+
+namespace {
+    uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void updateMax(std::atomic<uint64_t>& max, uint64_t value) {
+        uint64_t current = max.load(std::memory_order_relaxed);
+        while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    // Shared holders are many, so each thread remembers when it took which lock
+    thread_local std::vector<std::pair<const void*, uint64_t>> sharedSince;
+
+    uint64_t popSharedSince(const void* mutex) {
+        for (size_t i = sharedSince.size(); i-- > 0;) {
+            if (sharedSince[i].first == mutex) {
+                uint64_t since = sharedSince[i].second;
+                sharedSince.erase(sharedSince.begin() + i);
+                return since;
+            }
+        }
+        return nowNs();
+    }
+}
+
+void ProfiledSharedMutex::lock() {
+    if (!mutex_.try_lock()) {
+        uint64_t start = nowNs();
+        mutex_.lock();
+        uint64_t waited = nowNs() - start;
+        exclusiveContended_.fetch_add(1, std::memory_order_relaxed);
+        exclusiveWaitNs_.fetch_add(waited, std::memory_order_relaxed);
+        updateMax(maxExclusiveWaitNs_, waited);
+    }
+    exclusiveAcquisitions_.fetch_add(1, std::memory_order_relaxed);
+    exclusiveSince_ = nowNs();
+}
+
+bool ProfiledSharedMutex::try_lock() {
+    if (!mutex_.try_lock()) return false;
+    exclusiveAcquisitions_.fetch_add(1, std::memory_order_relaxed);
+    exclusiveSince_ = nowNs();
+    return true;
+}
+
+void ProfiledSharedMutex::unlock() {
+    exclusiveHoldNs_.fetch_add(nowNs() - exclusiveSince_, std::memory_order_relaxed);
+    mutex_.unlock();
+}
+
+void ProfiledSharedMutex::lock_shared() {
+    if (!mutex_.try_lock_shared()) {
+        uint64_t start = nowNs();
+        mutex_.lock_shared();
+        uint64_t waited = nowNs() - start;
+        sharedContended_.fetch_add(1, std::memory_order_relaxed);
+        sharedWaitNs_.fetch_add(waited, std::memory_order_relaxed);
+        updateMax(maxSharedWaitNs_, waited);
+    }
+    sharedAcquisitions_.fetch_add(1, std::memory_order_relaxed);
+    sharedSince.emplace_back(this, nowNs());
+}
+
+bool ProfiledSharedMutex::try_lock_shared() {
+    if (!mutex_.try_lock_shared()) return false;
+    sharedAcquisitions_.fetch_add(1, std::memory_order_relaxed);
+    sharedSince.emplace_back(this, nowNs());
+    return true;
+}
+
+void ProfiledSharedMutex::unlock_shared() {
+    sharedHoldNs_.fetch_add(nowNs() - popSharedSince(this), std::memory_order_relaxed);
+    mutex_.unlock_shared();
+}
+
+LockStats ProfiledSharedMutex::stats() const {
+    LockStats s;
+    s.exclusiveAcquisitions = exclusiveAcquisitions_.load(std::memory_order_relaxed);
+    s.exclusiveContended = exclusiveContended_.load(std::memory_order_relaxed);
+    s.exclusiveWaitNs = exclusiveWaitNs_.load(std::memory_order_relaxed);
+    s.exclusiveHoldNs = exclusiveHoldNs_.load(std::memory_order_relaxed);
+    s.maxExclusiveWaitNs = maxExclusiveWaitNs_.load(std::memory_order_relaxed);
+    s.sharedAcquisitions = sharedAcquisitions_.load(std::memory_order_relaxed);
+    s.sharedContended = sharedContended_.load(std::memory_order_relaxed);
+    s.sharedWaitNs = sharedWaitNs_.load(std::memory_order_relaxed);
+    s.sharedHoldNs = sharedHoldNs_.load(std::memory_order_relaxed);
+    s.maxSharedWaitNs = maxSharedWaitNs_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void ProfiledSharedMutex::resetStats() {
+    for (auto* counter : {&exclusiveAcquisitions_, &exclusiveContended_, &sharedAcquisitions_, &sharedContended_}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    for (auto* counter : {&exclusiveWaitNs_, &exclusiveHoldNs_, &maxExclusiveWaitNs_,
+                          &sharedWaitNs_, &sharedHoldNs_, &maxSharedWaitNs_}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+}
+
+#endif // HYBRID_HASH_LOCK_PROFILING
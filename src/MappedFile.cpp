@@ -0,0 +1,73 @@
+#include "MappedFile.hpp"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(other.data_), size_(other.size_), open_(other.open_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.open_ = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = other.data_;
+        size_ = other.size_;
+        open_ = other.open_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.open_ = false;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open file " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        std::cerr << "Error: Cannot stat " << path << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "Error: Cannot map " << path << ": " << std::strerror(errno) << "\n";
+            ::close(fd);
+            return false;
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL);  // Built with one front-to-back pass
+        data_ = static_cast<const char*>(mapping);
+    }
+    ::close(fd);  // The mapping stays valid
+    size_ = size;
+    open_ = true;
+    return true;
+}
+
+void MappedFile::adviseRandom() {
+    if (data_) madvise(const_cast<char*>(data_), size_, MADV_RANDOM);
+}
+
+void MappedFile::close() {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
@@ -0,0 +1,103 @@
+#include "MappedIndex.hpp"
+#include "CardinalityEstimator.hpp"
+#include "CpuDispatch.hpp"
+#include "HashFunctions.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+bool MappedIndex::build(const std::string& path) {
+    entries_.clear();
+    size_ = 0;
+    duplicates_ = 0;
+    if (!file_.open(path)) return false;
+    const char* data = file_.data();
+    size_t length = file_.size();
+
+    // Pass 1: count lines and estimate distinct keys to size the table once. The
+    // line count bounds the estimate; an underestimate regrows to it.
+    size_t lines = 0;
+    HyperLogLog distinct;
+    for (size_t pos = 0; pos < length;) {
+        size_t lineLength = CpuDispatch::findByte(data + pos, length - pos, '\n');
+        distinct.add(hashKey(std::string_view(data + pos, CpuDispatch::findByte(data + pos, lineLength, ','))));
+        pos += lineLength + 1;
+        lines++;
+    }
+    size_t planned = std::min(lines, static_cast<size_t>(distinct.estimate() * (1.0 + 3.0 * distinct.relativeError())) + 1);
+    entries_.assign(static_cast<size_t>(planned / MAX_LOAD_FACTOR) + 1, Entry{0, 0, 0});
+
+    // Pass 2: hash and index every line in place
+    size_t skipped = 0;
+    for (size_t pos = 0; pos < length;) {
+        size_t lineLength = CpuDispatch::findByte(data + pos, length - pos, '\n');
+        std::string_view line(data + pos, lineLength);
+        size_t comma = CpuDispatch::findByte(line.data(), line.size(), ',');
+        if (comma == line.size() || comma + 1 == line.size()) {
+            // Need a key and a non-empty value
+        } else if (pos > MAX_OFFSET || comma > MAX_KEY_LENGTH || lineLength > std::numeric_limits<uint32_t>::max()) {
+            skipped++;
+        } else {
+            if (size_ == planned && planned < lines) {
+                planned = lines;
+                regrow(static_cast<size_t>(planned / MAX_LOAD_FACTOR) + 1);
+            }
+            if (!insert(line.substr(0, comma), pos, lineLength)) duplicates_++;
+        }
+        pos += lineLength + 1;
+    }
+    if (skipped > 0) std::cerr << "Warning: " << skipped << " lines in " << path << " exceed the index limits\n";
+    file_.adviseRandom();
+    return true;
+}
+
+std::optional<std::string_view> MappedIndex::find(std::string_view key) const {
+    if (entries_.empty()) return std::nullopt;
+    uint64_t hash = hashKey(key);
+    uint32_t fingerprint = static_cast<uint32_t>(hash);
+    for (size_t i = home(hash);; i = (i + 1 == entries_.size()) ? 0 : i + 1) {
+        const Entry& entry = entries_[i];
+        if (entry.lineLength == 0) return std::nullopt;
+        if (entry.fingerprint == fingerprint && entry.keyLength() == key.size() && keyAt(entry) == key) {
+            size_t valueStart = entry.keyLength() + 1;  // Skip the comma
+            return std::string_view(file_.data() + entry.offset() + valueStart, entry.lineLength - valueStart);
+        }
+    }
+}
+
+uint64_t MappedIndex::hashKey(std::string_view key) {
+    return HashUtils::mix(std::hash<std::string_view>{}(key));
+}
+
+size_t MappedIndex::home(uint64_t hash) const {
+    return static_cast<size_t>((static_cast<unsigned __int128>(hash) * entries_.size()) >> 64);
+}
+
+// Linear probing; the table is sized for every line, so there is always an empty slot
+bool MappedIndex::insert(std::string_view key, uint64_t offset, size_t lineLength) {
+    uint64_t hash = hashKey(key);
+    uint32_t fingerprint = static_cast<uint32_t>(hash);
+    for (size_t i = home(hash);; i = (i + 1 == entries_.size()) ? 0 : i + 1) {
+        Entry& entry = entries_[i];
+        if (entry.lineLength == 0) {
+            entry.fingerprint = fingerprint;
+            entry.lineLength = static_cast<uint32_t>(lineLength);
+            entry.offsetAndKeyLength = offset | (static_cast<uint64_t>(key.size()) << 40);
+            size_++;
+            return true;
+        }
+        if (entry.fingerprint == fingerprint && entry.keyLength() == key.size() && keyAt(entry) == key) return false;
+    }
+}
+
+void MappedIndex::regrow(size_t capacity) {
+    std::vector<Entry> old(capacity, Entry{0, 0, 0});
+    old.swap(entries_);
+    for (const Entry& entry : old) {
+        if (entry.lineLength == 0) continue;
+        size_t i = home(hashKey(keyAt(entry)));
+        while (entries_[i].lineLength != 0) i = (i + 1 == entries_.size()) ? 0 : i + 1;
+        entries_[i] = entry;
+    }
+}
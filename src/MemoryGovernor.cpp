@@ -0,0 +1,131 @@
+#include "MemoryGovernor.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+    const size_t UNLIMITED_V1 = size_t(1) << 62;  // cgroup v1 reports "no limit" as a page-rounded LONG_MAX
+
+    bool fileExists(const std::string& path) {
+        return std::ifstream(path).good();
+    }
+}
+
+MemoryGovernor MemoryGovernor::fromCgroup(double reserveFraction) {
+    MemoryGovernor governor;
+    governor.reserveFraction_ = reserveFraction;
+
+    // Find this process's memory cgroup: "0::/path" on v2, "N:...memory...:/path" on v1
+    std::ifstream cgroups("/proc/self/cgroup");
+    std::string line, base, limitName, usageName, path;
+    while (std::getline(cgroups, line)) {
+        size_t first = line.find(':');
+        size_t second = line.find(':', first + 1);
+        if (first == std::string::npos || second == std::string::npos) continue;
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        std::string cgroupPath = line.substr(second + 1);
+        if (controllers.empty() && fileExists("/sys/fs/cgroup/cgroup.controllers")) {
+            base = "/sys/fs/cgroup";
+            limitName = "memory.max";
+            usageName = "memory.current";
+            path = cgroupPath;
+            break;  // v2 wins over v1
+        }
+        std::stringstream list(controllers);
+        std::string controller;
+        while (std::getline(list, controller, ',')) {
+            if (controller != "memory") continue;
+            base = "/sys/fs/cgroup/memory";
+            limitName = "memory.limit_in_bytes";
+            usageName = "memory.usage_in_bytes";
+            path = cgroupPath;
+        }
+    }
+    if (base.empty()) return governor;
+
+    // Every level from ours up to the mount root can carry a limit; all of them apply.
+    // Inside a cgroup namespace the listed path may not exist, but the root still does.
+    std::string dir = base + (path == "/" ? "" : path);
+    for (;;) {
+        size_t bytes;
+        if (readBytes(dir + "/" + limitName, bytes) && bytes < UNLIMITED_V1) {
+            governor.levels_.push_back({dir + "/" + limitName, dir + "/" + usageName});
+        }
+        if (dir.size() <= base.size()) break;
+        dir.erase(dir.rfind('/'));
+    }
+    governor.limited_ = !governor.levels_.empty();
+    if (governor.limited_) governor.source_ = "cgroup " + governor.levels_.front().limitFile;
+    return governor;
+}
+
+MemoryGovernor MemoryGovernor::withBudget(size_t budgetBytes, double reserveFraction) {
+    MemoryGovernor governor;
+    governor.budget_ = budgetBytes;
+    governor.reserveFraction_ = reserveFraction;
+    governor.limited_ = true;
+    governor.source_ = "budget";
+    return governor;
+}
+
+size_t MemoryGovernor::limit() const {
+    if (!limited_) return SIZE_MAX;
+    if (levels_.empty()) return budget_;
+    size_t tightest = SIZE_MAX;
+    for (const Level& level : levels_) {
+        size_t bytes;
+        if (readBytes(level.limitFile, bytes)) tightest = std::min(tightest, bytes);
+    }
+    return tightest;
+}
+
+size_t MemoryGovernor::usage() const {
+    if (levels_.empty()) return residentBytes();
+    size_t bytes = 0;
+    readBytes(levels_.front().usageFile, bytes);  // Our own level: what this process group is charged
+    return bytes;
+}
+
+size_t MemoryGovernor::headroom() const {
+    if (!limited_) return SIZE_MAX;
+    if (levels_.empty()) {
+        size_t used = residentBytes();
+        return used < budget_ ? budget_ - used : 0;
+    }
+    // The smallest gap across the hierarchy: a parent may be closer to its limit than we are
+    size_t smallest = SIZE_MAX;
+    for (const Level& level : levels_) {
+        size_t max, current;
+        if (!readBytes(level.limitFile, max) || !readBytes(level.usageFile, current)) continue;
+        smallest = std::min(smallest, current < max ? max - current : 0);
+    }
+    return smallest;
+}
+
+bool MemoryGovernor::allows(size_t bytes) const {
+    if (!limited_) return true;
+    size_t free = headroom();
+    size_t reserve = static_cast<size_t>(static_cast<double>(limit()) * reserveFraction_);
+    return free >= reserve && bytes <= free - reserve;
+}
+
+bool MemoryGovernor::readBytes(const std::string& path, size_t& bytes) {
+    std::ifstream file(path);
+    std::string text;
+    if (!(file >> text)) return false;  // "max" fails the digit check below
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end != '\0') return false;
+    bytes = static_cast<size_t>(value);
+    return true;
+}
+
+size_t MemoryGovernor::residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0, residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
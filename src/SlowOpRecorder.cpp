@@ -0,0 +1,90 @@
+#include "SlowOpRecorder.hpp"
+#include "HybridHashTable.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+    const char* opName(SlowOpType op) {
+        switch (op) {
+            case SlowOpType::Insert: return "insert";
+            case SlowOpType::Search: return "search";
+            case SlowOpType::Remove: return "remove";
+            case SlowOpType::Resize: return "resize";
+            case SlowOpType::Update: return "update";
+        }
+        return "?";
+    }
+
+    const char* modeName(HashMode mode) {
+        switch (mode) {
+            case HashMode::Cuckoo: return "Cuckoo";
+            case HashMode::Hopscotch: return "Hopscotch";
+            case HashMode::RobinHood: return "RobinHood";
+        }
+        return "?";
+    }
+}
+
+SlowOpRecorder::SlowOpRecorder(double thresholdUs, size_t capacity)
+    : threshold_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::micro>(thresholdUs))),
+      capacity_(std::max<size_t>(capacity, 1)), start_(Clock::now()), next_(0), recorded_(0) {
+    ring_.reserve(capacity_);
+}
+
+void SlowOpRecorder::record(Clock::time_point start, Clock::time_point end, SlowOp op) {
+    op.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(start - start_).count());
+    op.durationUs = std::chrono::duration<double, std::micro>(end - start).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ring_.size() < capacity_) {
+        ring_.push_back(op);
+    } else {
+        ring_[next_] = op;
+    }
+    next_ = (next_ + 1) % capacity_;
+    recorded_++;
+}
+
+std::vector<SlowOp> SlowOpRecorder::recent() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ring_.size() < capacity_) return ring_;
+    std::vector<SlowOp> ordered(ring_.begin() + next_, ring_.end());
+    ordered.insert(ordered.end(), ring_.begin(), ring_.begin() + next_);
+    return ordered;
+}
+
+size_t SlowOpRecorder::recorded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recorded_;
+}
+
+void SlowOpRecorder::dump(std::ostream& out) const {
+    std::vector<SlowOp> ops = recent();
+    out << recorded() << " operations over " << thresholdUs() << "us, last " << ops.size() << ":\n";
+    for (const SlowOp& op : ops) {
+        out << std::fixed << std::setprecision(6) << "+" << op.timestampNs / 1e9 << "s " << opName(op.op) << " "
+            << std::setprecision(1) << op.durationUs << "us mode=" << modeName(op.mode) << " probes=" << op.probes
+            << " displacements=" << op.displacements << " stash=" << op.stashSize << " size=" << op.size
+            << " capacity=" << op.capacity << " resized=" << (op.resized ? "yes" : "no") << " key=0x" << std::hex
+            << op.keyHash << std::dec << "\n";
+    }
+    out << std::defaultfloat;
+}
+
+bool SlowOpRecorder::dumpToFile(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "Error: Cannot write " << filename << "\n";
+        return false;
+    }
+    dump(file);
+    return true;
+}
+
+void SlowOpRecorder::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ring_.clear();
+    next_ = 0;
+    recorded_ = 0;
+}
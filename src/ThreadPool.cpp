@@ -0,0 +1,170 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    const size_t CHUNKS_PER_THREAD = 4;  // parallelFor granularity: enough chunks to balance by stealing
+
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local size_t currentIndex = 0;
+
+    std::mutex defaultMutex;
+    std::shared_ptr<ThreadPool> defaultInstance;
+}
+
+ThreadPool::ThreadPool(size_t threads, bool pinThreads)
+    : queued_(0), nextQueue_(0), steals_(0), stopping_(false) {
+    if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t i = 0; i < threads; ++i) workers_.push_back(std::make_unique<Worker>());
+    for (size_t i = 0; i < threads; ++i) workers_[i]->thread = std::thread(&ThreadPool::run, this, i, pinThreads);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker->thread.join();
+}
+
+void ThreadPool::submit(Task task) {
+    size_t index = currentWorker();
+    if (index == workers_.size()) index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    queued_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);  // Pairs with the sleep check, so the wakeup is not lost
+    }
+    wake_.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (end <= begin) return;
+    size_t count = end - begin;
+    size_t chunk = std::max<size_t>(grain, 1);
+    chunk = std::max(chunk, (count + workers_.size() * CHUNKS_PER_THREAD - 1) / (workers_.size() * CHUNKS_PER_THREAD));
+    size_t chunks = (count + chunk - 1) / chunk;
+    if (chunks == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    // Per-call task group: helpers and the caller claim chunks from a shared counter,
+    // so the caller only ever runs this loop's chunks. Helpers that start after the
+    // last chunk was claimed find nothing and return.
+    struct Group {
+        const std::function<void(size_t, size_t)>* fn;
+        size_t begin, end, chunk, chunks;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        bool runChunk() {
+            size_t c = next.fetch_add(1, std::memory_order_relaxed);
+            if (c >= chunks) return false;
+            size_t from = begin + c * chunk;
+            (*fn)(from, std::min(from + chunk, end));  // Claimed, so the caller is still waiting
+            if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+            return true;
+        }
+    };
+    auto group = std::make_shared<Group>();
+    group->fn = &fn;
+    group->begin = begin;
+    group->end = end;
+    group->chunk = chunk;
+    group->chunks = chunks;
+
+    size_t helpers = std::min(chunks - 1, workers_.size());
+    for (size_t h = 0; h < helpers; ++h) {
+        submit([group] { while (group->runChunk()) {} });
+    }
+    while (group->runChunk()) {}
+
+    // Every chunk is claimed; the ones still running are on threads making progress
+    std::unique_lock<std::mutex> lock(group->mutex);
+    group->finished.wait(lock, [&group] { return group->done.load(std::memory_order_acquire) == group->chunks; });
+}
+
+void ThreadPool::helpUntil(const std::function<bool()>& done) {
+    size_t home = currentWorker();
+    while (!done()) {
+        if (!runOne(home)) std::this_thread::yield();
+    }
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::defaultPool() {
+    std::lock_guard<std::mutex> lock(defaultMutex);
+    if (!defaultInstance) defaultInstance = std::make_shared<ThreadPool>();
+    return defaultInstance;
+}
+
+void ThreadPool::setDefault(std::shared_ptr<ThreadPool> pool) {
+    std::lock_guard<std::mutex> lock(defaultMutex);
+    defaultInstance = std::move(pool);
+}
+
+void ThreadPool::run(size_t index, bool pin) {
+    currentPool = this;
+    currentIndex = index;
+#ifdef __linux__
+    if (pin) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(index % std::max(std::thread::hardware_concurrency(), 1u), &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#else
+    (void)pin;
+#endif
+    for (;;) {
+        if (runOne(index)) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+        if (stopping_ && queued_.load() == 0) return;
+    }
+}
+
+bool ThreadPool::runOne(size_t home) {
+    Task task;
+    bool found = home < workers_.size() && popBack(*workers_[home], task);
+    for (size_t i = 1; !found && i <= workers_.size(); ++i) {
+        found = popFront(*workers_[(home + i) % workers_.size()], task);
+        if (found) steals_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!found) return false;
+    queued_.fetch_sub(1);
+    task();
+    return true;
+}
+
+bool ThreadPool::popBack(Worker& worker, Task& task) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::popFront(Worker& worker, Task& task) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    return true;
+}
+
+size_t ThreadPool::currentWorker() const {
+    return currentPool == this ? currentIndex : workers_.size();
+}
@@ -0,0 +1,185 @@
+#include "TraceRecorder.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace {
+    const char TRACE_MAGIC[8] = {'H', 'H', 'T', 'R', 'A', 'C', 'E', '1'};
+    const size_t RECORD_HEADER_BYTES = 8 + 8 + 1 + 4;
+
+    std::atomic<uint64_t> nextRecorderId{1};
+
+    // Recorders that exiting threads may still hand buffers back to. Held while a
+    // thread releases its buffers, so a recorder cannot be destroyed under it.
+    std::mutex liveMutex;
+    std::vector<TraceRecorder*> liveRecorders;
+
+    template <typename T>
+    void put(char*& out, T value) {
+        std::memcpy(out, &value, sizeof(T));
+        out += sizeof(T);
+    }
+}
+
+// Recorder ids are never reused, so entries of destroyed recorders are never matched
+struct TraceRecorder::ThreadBuffers {
+    std::vector<std::pair<uint64_t, ThreadBuffer*>> entries;
+
+    ~ThreadBuffers() {
+        std::lock_guard<std::mutex> lock(liveMutex);
+        for (const auto& entry : entries) {
+            for (TraceRecorder* recorder : liveRecorders) {
+                if (recorder->id_ == entry.first) recorder->releaseBuffer(entry.second);
+            }
+        }
+    }
+
+    void dropDestroyed() {
+        std::lock_guard<std::mutex> lock(liveMutex);
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const auto& entry) {
+            return std::none_of(liveRecorders.begin(), liveRecorders.end(),
+                                [&](const TraceRecorder* recorder) { return recorder->id_ == entry.first; });
+        }), entries.end());
+    }
+};
+
+thread_local TraceRecorder::ThreadBuffers TraceRecorder::threadBuffers_;
+
+TraceRecorder::TraceRecorder(const std::string& filename, size_t sampleRate, bool recordKeys, size_t bufferBytes)
+    : id_(nextRecorderId.fetch_add(1)), file_(std::fopen(filename.c_str(), "wb")),
+      sampleRate_(sampleRate > 0 ? sampleRate : 1), recordKeys_(recordKeys),
+      bufferBytes_(bufferBytes > RECORD_HEADER_BYTES ? bufferBytes : RECORD_HEADER_BYTES),
+      start_(std::chrono::steady_clock::now()), recorded_(0) {
+    if (!file_) {
+        std::cerr << "Error: Cannot open trace file " << filename << "\n";
+        return;
+    }
+    std::fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), file_);
+    std::lock_guard<std::mutex> lock(liveMutex);
+    liveRecorders.push_back(this);
+}
+
+TraceRecorder::~TraceRecorder() {
+    {
+        std::lock_guard<std::mutex> lock(liveMutex);
+        liveRecorders.erase(std::remove(liveRecorders.begin(), liveRecorders.end(), this), liveRecorders.end());
+    }
+    flush();
+    if (file_) std::fclose(file_);
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::localBuffer() {
+    for (const auto& entry : threadBuffers_.entries) {
+        if (entry.first == id_) return *entry.second;
+    }
+    threadBuffers_.dropDestroyed();  // Only when a new buffer is added, so the list stays short
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->data.resize(bufferBytes_);
+    ThreadBuffer* raw = buffer.get();
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        buffers_.push_back(std::move(buffer));
+    }
+    threadBuffers_.entries.emplace_back(id_, raw);
+    return *raw;
+}
+
+void TraceRecorder::record(TraceOp op, uint64_t keyHash, const char* key, size_t keyLength) {
+    if (!file_) return;
+    if (!recordKeys_) keyLength = 0;
+    uint64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    size_t needed = RECORD_HEADER_BYTES + keyLength;
+    if (buffer.used + needed > buffer.data.size()) writeOut(buffer);
+    std::vector<char> oversized;  // Buffers never grow: a record that does not fit is written on its own
+    if (needed > buffer.data.size()) oversized.resize(needed);
+    char* begin = oversized.empty() ? buffer.data.data() + buffer.used : oversized.data();
+    char* out = begin;
+    put(out, timestamp);
+    put(out, keyHash);
+    put(out, static_cast<uint8_t>(op));
+    put(out, static_cast<uint32_t>(keyLength));
+    if (keyLength > 0) std::memcpy(out, key, keyLength);
+    if (oversized.empty()) {
+        buffer.used += needed;
+    } else {
+        writeBytes(begin, needed);
+    }
+    recorded_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TraceRecorder::writeOut(ThreadBuffer& buffer) {
+    if (buffer.used == 0) return;
+    writeBytes(buffer.data.data(), buffer.used);
+    buffer.used = 0;
+}
+
+void TraceRecorder::writeBytes(const char* data, size_t size) {
+    std::lock_guard<std::mutex> lock(fileMutex_);
+    std::fwrite(data, 1, size, file_);
+}
+
+void TraceRecorder::releaseBuffer(ThreadBuffer* buffer) {
+    std::lock_guard<std::mutex> registryLock(registryMutex_);
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if (file_) writeOut(*buffer);
+    }
+    buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                  [buffer](const std::unique_ptr<ThreadBuffer>& owned) { return owned.get() == buffer; }),
+                   buffers_.end());
+}
+
+void TraceRecorder::flush() {
+    if (!file_) return;
+    std::lock_guard<std::mutex> registryLock(registryMutex_);
+    for (auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        writeOut(*buffer);
+    }
+    std::lock_guard<std::mutex> lock(fileMutex_);
+    std::fflush(file_);
+}
+
+bool TraceRecorder::readTrace(const std::string& filename, std::vector<TraceRecord>& records) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Error: Cannot open trace file " << filename << "\n";
+        return false;
+    }
+    char magic[sizeof(TRACE_MAGIC)];
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+        std::cerr << "Error: " << filename << " is not a trace file\n";
+        std::fclose(file);
+        return false;
+    }
+
+    char header[RECORD_HEADER_BYTES];
+    while (std::fread(header, 1, sizeof(header), file) == sizeof(header)) {
+        TraceRecord record;
+        uint8_t op;
+        uint32_t keyLength;
+        std::memcpy(&record.timestampNs, header, 8);
+        std::memcpy(&record.keyHash, header + 8, 8);
+        std::memcpy(&op, header + 16, 1);
+        std::memcpy(&keyLength, header + 17, 4);
+        if (op > static_cast<uint8_t>(TraceOp::Update)) {
+            std::cerr << "Error: " << filename << " has an unknown operation " << int(op) << "\n";
+            break;
+        }
+        record.op = static_cast<TraceOp>(op);
+        record.key.resize(keyLength);
+        if (keyLength > 0 && std::fread(&record.key[0], 1, keyLength, file) != keyLength) break;  // Truncated tail
+        records.push_back(std::move(record));
+    }
+    std::fclose(file);
+    // Thread buffers are flushed independently, so restore global time order
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.timestampNs < b.timestampNs;
+    });
+    return true;
+}
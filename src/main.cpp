@@ -1,36 +1,22 @@
 #include "HybridHashTable.hpp"
+#include "DataLoader.hpp"
+#include "CpuDispatch.hpp"
+#include "MappedIndex.hpp"
+#include <cstdlib>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <thread>
 #include <chrono>
 
-void loadFromFile(HybridHashTable<std::string, std::string>& table, const std::string& filename, std::vector<std::string>& keys) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open file " << filename << "\n";
-        return;
-    }
-
-    std::string line;
-    size_t inserted = 0;
-    auto start = std::chrono::high_resolution_clock::now();
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string key, value;
-        if (std::getline(ss, key, ',') && std::getline(ss, value)) {
-            if (table.insert(key, value)) {
-                inserted++;
-                keys.push_back(key);  // Store keys for later operations
-            }
-        }
-    }
-    auto end = std::chrono::high_resolution_clock::now();
-    double time = std::chrono::duration<double>(end - start).count();
-    file.close();
-    std::cout << inserted << " items inserted in " << time << "s (" << inserted / time << " inserts/sec)\n";
+void printLockStats(const HybridHashTable<std::string, std::string>& table) {
+    if (!LOCK_PROFILING_ENABLED) return;
+    LockStats lock = table.stats().lock;
+    std::cout << "Lock: " << lock.exclusiveAcquisitions << " exclusive (" << lock.exclusiveContended << " contended, "
+              << lock.exclusiveWaitNs / 1e6 << "ms waiting, max " << lock.maxExclusiveWaitNs / 1e3 << "us, "
+              << lock.exclusiveHoldNs / 1e6 << "ms held), " << lock.sharedAcquisitions << " shared ("
+              << lock.sharedContended << " contended, " << lock.sharedWaitNs / 1e6 << "ms waiting, max "
+              << lock.maxSharedWaitNs / 1e3 << "us, " << lock.sharedHoldNs / 1e6 << "ms held)\n";
 }
 
 void performOperations(HybridHashTable<std::string, std::string>& table, const std::vector<std::string>& keys) {
@@ -53,20 +39,85 @@ void performOperations(HybridHashTable<std::string, std::string>& table, const s
     auto removeEnd = std::chrono::high_resolution_clock::now();
     double removeTime = std::chrono::duration<double>(removeEnd - removeStart).count();
     std::cout << removed << " items removed (out of " << keys.size() << ") in " << removeTime << "s (" << keys.size() / removeTime << " removes/sec)\n";
+    printLockStats(table);
 }
 
-int main() {
-    HybridHashTable<std::string, std::string> table(1000000, 2.0);
+// Index-only alternative: entries point into the mapped file instead of holding copies
+void indexFile(const std::string& filename, const std::vector<std::string>& keys) {
+    MappedIndex index;
+    auto buildStart = std::chrono::high_resolution_clock::now();
+    if (!index.build(filename)) return;
+    double buildTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - buildStart).count();
+    std::cout << index.size() << " items indexed in " << buildTime << "s (" << index.memoryBytes() / (1 << 20)
+              << " MiB, " << static_cast<double>(index.memoryBytes()) / index.size() << " bytes/item)\n";
+
+    size_t found = 0;
+    auto searchStart = std::chrono::high_resolution_clock::now();
+    for (const auto& key : keys) {
+        if (index.find(key)) found++;
+    }
+    double searchTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - searchStart).count();
+    std::cout << found << " items found in the index (out of " << keys.size() << ") in " << searchTime << "s ("
+              << keys.size() / searchTime << " searches/sec)\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << CpuDispatch::report() << "\n";
+
+    HybridHashTable<std::string, std::string> table(1024, 2.0);  // loadFromFile presizes it from the data
     table.setMode(HashMode::RobinHood);
 
+    // --trace <file> records every operation for later replay with trace_replay;
+    // --index also runs the lookups against a MappedIndex of the same file;
+    // --data <file, directory or glob> loads those files instead of data.csv, with
+    // --last-wins letting later files overwrite duplicate keys; --slow-ops <us> prints
+    // the last operations slower than that at exit
+    std::shared_ptr<TraceRecorder> trace;
+    std::string traceFile;
+    bool index = false;
+    std::string dataPattern;
+    DuplicatePolicy policy = DuplicatePolicy::FirstWins;
+    std::shared_ptr<SlowOpRecorder> slowOps;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc) {
+            traceFile = argv[++i];
+            trace = std::make_shared<TraceRecorder>(traceFile);
+            table.setTraceRecorder(trace);
+        } else if (arg == "--index") {
+            index = true;
+        } else if (arg == "--data" && i + 1 < argc) {
+            dataPattern = argv[++i];
+        } else if (arg == "--last-wins") {
+            policy = DuplicatePolicy::LastWins;
+        } else if (arg == "--slow-ops" && i + 1 < argc) {
+            slowOps = std::make_shared<SlowOpRecorder>(std::atof(argv[++i]));
+            table.setSlowOpRecorder(slowOps);
+        }
+    }
+
     std::vector<std::string> keys;  // To store keys for operations
 
     // Load data from file
-    loadFromFile(table, "data.csv", keys);
+    std::vector<std::string> files;
+    if (dataPattern.empty()) {
+        loadFromFile(table, "data.csv", keys);
+    } else if (expandFilePattern(dataPattern, files)) {
+        loadFromFiles(table, files, keys, policy);
+    } else {
+        return 1;
+    }
     std::cout << "Final size: " << table.size() << ", load factor: " << table.loadFactor() << "\n";
 
     // Perform operations on all items
     performOperations(table, keys);
 
+    if (trace) {
+        table.setTraceRecorder(nullptr);
+        trace->flush();
+        std::cout << trace->recorded() << " operations traced to " << traceFile << "\n";
+    }
+    if (slowOps) slowOps->dump(std::cout);
+    if (index && dataPattern.empty()) indexFile("data.csv", keys);
     return 0;
 }
\ No newline at end of file
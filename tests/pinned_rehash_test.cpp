@@ -0,0 +1,49 @@
+#include "HybridHashTable.hpp"
+#include <iostream>
+#include <string>
+
+// A hot key pinned in the front table must survive growth, resize() and reseed()
+// in every mode, without duplicating or dropping any other key
+
+int checkContents(HybridHashTable<std::string, int>& table, int keys, const std::string& step) {
+    int failures = 0;
+    if (!table.search("hot")) failures++;
+    for (int i = 0; i < keys; ++i) {
+        if (!table.search("k" + std::to_string(i))) failures++;
+    }
+    if (table.size() != static_cast<size_t>(keys + 1)) failures++;
+    if (failures) std::cerr << step << ": size " << table.size() << ", expected " << keys + 1 << "\n";
+    return failures;
+}
+
+int main() {
+    int failures = 0;
+    for (HashMode mode : {HashMode::Hopscotch, HashMode::RobinHood, HashMode::Cuckoo}) {
+        for (int keys : {20000, 60000}) {  // Serial and parallel rehash
+            HybridHashTable<std::string, int> table(1024, 0.75);
+            table.setMode(mode);
+            table.enableHotKeyTracking(1, 64, 4);
+            table.insert("hot", 1);
+            for (int i = 0; i < keys; ++i) {
+                table.insert("k" + std::to_string(i), i);
+                table.search("hot");
+            }
+            failures += checkContents(table, keys, "growth");
+            if (!table.resize(table.capacity() * 2)) failures++;
+            failures += checkContents(table, keys, "resize");
+            table.reseed(42);
+            for (int i = 0; i < 100; ++i) table.search("hot");
+            failures += checkContents(table, keys, "reseed");
+
+            bool pinned = false;
+            for (const auto& key : table.stats().pinnedKeys) pinned |= key == "hot";
+            if (!pinned) {
+                std::cerr << "hot key not pinned\n";
+                failures++;
+            }
+            if (table.stats().failedRehashes != 0) failures++;
+        }
+    }
+    std::cout << (failures ? "FAILED" : "passed") << "\n";
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+#include "Benchmark.hpp"
+#include "DataLoader.hpp"
+#include "TraceRecorder.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+
+// Usage: autotune (--trace <file> | --keys <file>) [--repeat N] [--out <file>]
+// Grid-searches mode, table parameters and load factor by replaying the workload
+// through the benchmark harness, then prints the fastest configuration that kept
+// the stash (the overflow fallback) essentially empty. The switching thresholds
+// are left out: automatic mode switching is disabled, so the table never reads them.
+
+namespace {
+    struct Candidate {
+        HashMode mode;
+        HashTableConfig config;
+        size_t capacity;
+        BenchmarkResult result;
+    };
+
+    const double LOAD_FACTORS[] = {0.5, 0.7, 0.85};
+    const size_t HOP_RANGES[] = {8, 16, 32};
+    const size_t MAX_DISPLACEMENTS[] = {64, 500};
+    const size_t MAX_PROBE_DISTANCES[] = {32, 128, 500};
+    const int MAX_EVICTIONS[] = {16, 100, 500};
+    const double MAX_STASH_SHARE = 0.001;  // Stash scans are linear; more than 0.1% of keys there disqualifies
+
+    std::vector<Candidate> buildGrid(size_t distinctKeys) {
+        std::vector<Candidate> grid;
+        for (double loadFactor : LOAD_FACTORS) {
+            HashTableConfig base;
+            base.maxLoadFactor = loadFactor;
+            size_t capacity = std::max<size_t>(16, static_cast<size_t>(std::ceil(distinctKeys / loadFactor)));
+            for (size_t hopRange : HOP_RANGES) {
+                for (size_t displacements : MAX_DISPLACEMENTS) {
+                    HashTableConfig config = base;
+                    config.hopRange = hopRange;
+                    config.maxDisplacements = displacements;
+                    grid.push_back({HashMode::Hopscotch, config, capacity, {}});
+                }
+            }
+            for (size_t probes : MAX_PROBE_DISTANCES) {
+                HashTableConfig config = base;
+                config.maxProbeDistance = probes;
+                grid.push_back({HashMode::RobinHood, config, capacity, {}});
+            }
+            for (int evictions : MAX_EVICTIONS) {
+                HashTableConfig config = base;
+                config.maxEvictions = evictions;
+                grid.push_back({HashMode::Cuckoo, config, capacity, {}});
+            }
+        }
+        return grid;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string traceFile, keyFile, outFile;
+    size_t repeat = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc) traceFile = argv[++i];
+        else if (arg == "--keys" && i + 1 < argc) keyFile = argv[++i];
+        else if (arg == "--repeat" && i + 1 < argc) repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+        else if (arg == "--out" && i + 1 < argc) outFile = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " (--trace <file> | --keys <file>) [--repeat N] [--out <file>]\n";
+            return 1;
+        }
+    }
+
+    std::vector<TraceRecord> trace;
+    if (!traceFile.empty()) {
+        if (!TraceRecorder::readTrace(traceFile, trace)) return 1;
+    } else if (!keyFile.empty()) {
+        std::vector<std::string> keys;
+        if (!readKeysFromFile(keyFile, keys)) return 1;
+        trace = syntheticTrace(keys);
+    } else {
+        std::cerr << "Error: Need --trace or --keys\n";
+        return 1;
+    }
+
+    std::unordered_set<uint64_t> distinct;
+    for (const auto& record : trace) distinct.insert(record.keyHash);
+    size_t stashLimit = static_cast<size_t>(distinct.size() * MAX_STASH_SHARE);
+
+    std::vector<Candidate> runs = buildGrid(distinct.size());
+    std::cout << "Tuning " << runs.size() << " configurations on " << trace.size() << " operations ("
+              << distinct.size() << " distinct keys)\n";
+    for (auto& run : runs) {
+        for (size_t r = 0; r < repeat; ++r) {
+            HybridHashTable<std::string, std::string> table(run.capacity, run.config);
+            table.setMode(run.mode);
+            BenchmarkResult result = replayTrace(table, trace);
+            if (r == 0 || result.opsPerSec > run.result.opsPerSec) run.result = result;
+        }
+        std::cout << "  " << hashModeName(run.mode) << " lf=" << run.config.maxLoadFactor << " H=" << run.config.hopRange
+                  << " disp=" << run.config.maxDisplacements << " probe=" << run.config.maxProbeDistance
+                  << " evict=" << run.config.maxEvictions << ": " << run.result.opsPerSec << " ops/sec, p99 "
+                  << run.result.p99Us << "us, peak stash " << run.result.peakStashSize << "\n";
+    }
+
+    // Fastest run that kept the stash small; fall back to the smallest stash
+    const Candidate* best = nullptr;
+    for (const auto& run : runs) {
+        if (run.result.peakStashSize > stashLimit) continue;
+        if (!best || run.result.opsPerSec > best->result.opsPerSec) best = &run;
+    }
+    if (!best) {
+        for (const auto& run : runs) {
+            if (!best || run.result.peakStashSize < best->result.peakStashSize) best = &run;
+        }
+    }
+    const HashTableConfig& recommended = best->config;
+
+    std::ofstream file;
+    if (!outFile.empty()) file.open(outFile);
+    std::ostream& out = outFile.empty() ? std::cout : file;
+    out << "# Recommended configuration: " << best->result.opsPerSec << " ops/sec, p99 " << best->result.p99Us << "us\n";
+    out << "mode = " << hashModeName(best->mode) << "\n";
+    out << "capacity = " << best->capacity << "\n";
+    out << "maxLoadFactor = " << recommended.maxLoadFactor << "\n";
+    out << "hopRange = " << recommended.hopRange << "\n";
+    out << "maxDisplacements = " << recommended.maxDisplacements << "\n";
+    out << "maxProbeDistance = " << recommended.maxProbeDistance << "\n";
+    out << "maxEvictions = " << recommended.maxEvictions << "\n";
+    if (!outFile.empty()) std::cout << "Recommendation written to " << outFile << "\n";
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include "HashAnalyzer.hpp"
+#include "DataLoader.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// Usage: hash_analyzer <keyfile> [capacity] [hopRange]
+// Reports how the table's hash functions spread the keys of a CSV file.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <keyfile> [capacity] [hopRange]\n";
+        return 1;
+    }
+
+    std::vector<std::string> keys;
+    if (!readKeysFromFile(argv[1], keys)) return 1;
+    // A table holds each key once, so repeated rows must not skew the distribution
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    // Default to the capacity main.cpp uses for data.csv-sized inputs: keys at load ~0.5
+    size_t capacity = argc > 2 ? std::stoul(argv[2]) : keys.size() * 2;
+    size_t hopRange = argc > 3 ? std::stoul(argv[3]) : 32;
+
+    HashAnalysis analysis = analyzeKeys(keys, capacity, hopRange);
+    printHashAnalysis(analysis, std::cout);
+    return 0;
+}
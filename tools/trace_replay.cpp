@@ -0,0 +1,51 @@
+#include "Benchmark.hpp"
+#include "TraceRecorder.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+// Usage: trace_replay <tracefile> [--mode cuckoo|hopscotch|robinhood] [--capacity N] [--paced]
+// Re-executes a recorded workload against a fresh table and reports throughput and latency.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <tracefile> [--mode cuckoo|hopscotch|robinhood] [--capacity N] [--paced]\n";
+        return 1;
+    }
+
+    HashMode mode = HashMode::RobinHood;
+    size_t capacity = 0;
+    bool paced = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--mode" && i + 1 < argc) {
+            if (!parseHashMode(argv[++i], mode)) {
+                std::cerr << "Error: Unknown mode " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--capacity" && i + 1 < argc) {
+            capacity = std::stoul(argv[++i]);
+        } else if (arg == "--paced") {
+            paced = true;
+        } else {
+            std::cerr << "Error: Unknown argument " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<TraceRecord> trace;
+    if (!TraceRecorder::readTrace(argv[1], trace)) return 1;
+
+    if (capacity == 0) {
+        // Size for the distinct keys at load ~0.5, like main.cpp does for data.csv
+        std::unordered_set<uint64_t> distinct;
+        for (const auto& record : trace) distinct.insert(record.keyHash);
+        capacity = std::max<size_t>(16, distinct.size() * 2);
+    }
+
+    HybridHashTable<std::string, std::string> table(capacity);
+    table.setMode(mode);
+    BenchmarkResult result = replayTrace(table, trace, paced);
+    printBenchmarkResult(std::string(hashModeName(mode)) + (paced ? " (paced)" : ""), result, std::cout);
+    return 0;
+}